@@ -8,7 +8,7 @@ Block Block::createBlock(const Blockchain& blockchain, const PubKey& minerPubKey
     Block block;
     block.index = blockchain.size();
     block.timestamp = static_cast<uint32_t>(time(nullptr));
-    block.previousHash = blockchain.size() > 0 ? blockchain[blockchain.size() - 1].getHash() : "0";
+    block.previousHash = blockchain.size() > 0 ? blockchain[blockchain.size() - 1].getHash() : Hash{};
     block.target = blockchain.getTargetAt(block.index);
 
     block.transactions = blockchain.getNewBlockTransactions(minerPubKey);
@@ -51,7 +51,7 @@ const bool Block::hashMatchesDifficulty() const {
             return false;
         }
     }
-    if (static_cast<uint8_t>(hash[target.value]) > target.max) {
+    if (target.value < Hash::SIZE && hash[target.value] > target.max) {
         return false;
     }
     return true;
@@ -5,8 +5,8 @@
 #include "transaction/BlockTransactions.hpp"
 #include <cereal/types/vector.hpp>
 #include <cereal/types/string.hpp>
-#include <cereal/archives/binary.hpp>
-#include <sstream>
+#include "network/ByteArchive.hpp"
+#include "network/BulkEncoding.hpp"
 
 class Blockchain;
 
@@ -42,7 +42,7 @@ struct Target{
 
     template<class Archive>
     void serialize(Archive& ar) {
-        ar(value, max);
+        bulk::record(ar, *this, value, max);
     }
 };
 
@@ -61,19 +61,23 @@ private:
     Hash previousHash;
     Hash hash;
 
+    // En-tête haché : les transactions n'y figurent que par leur racine de Merkle (taille fixe)
     template<typename Archive>
     void serialize_without_hash(Archive& ar) const {
-        ar(index, nonce, timestamp, target, transactions, previousHash);
+        const Hash merkleRoot = transactions.getMerkleRoot();
+        ar(index, nonce, timestamp, target, merkleRoot, previousHash);
     }
 
     // Fonctions
     Hash calculateHash() const {
-        std::ostringstream oss(std::ios::binary);
+        PooledBuffer header; // réutilisé d'un nonce à l'autre : aucune allocation
         {
-            cereal::BinaryOutputArchive ar(oss);
-            serialize_without_hash(ar); // sérialise tous les champs sauf 'hash'
+            cereal::ByteOutputArchive ar(header.get());
+            serialize_without_hash(ar); // sérialise l'en-tête sauf 'hash'
         }
-        return crypto::hashData(oss.str());
+        Hash hash;
+        crypto::hashData(header.bytes(), hash.bytes);
+        return hash;
     }
     const bool hashMatchesDifficulty() const;
 
@@ -1,12 +1,14 @@
 #include "Blockchain.hpp"
 
+#include <limits>
 
-const double Blockchain::getMiningRewardAt(uint32_t index) {
+
+const Amount Blockchain::getMiningRewardAt(uint32_t index) {
     uint32_t nbHalvings = index / 10000;
-    if (nbHalvings >= 64) {
-        return 0.0;
+    if (nbHalvings >= 63) {
+        return 0;
     }
-    return 100 / (1 << nbHalvings);
+    return (100 * COIN) >> nbHalvings;
     //supply max 2 millions de coin comme ca (environ 35 jours pas halving si block 5 min)
 }
 
@@ -59,57 +61,121 @@ const Target Blockchain::getTargetAt(uint32_t index) const {
 
 
 bool Blockchain::addBlock(const Block& block) {
-    //std::lock_guard<std::mutex> lk(mtx_);
+    std::unique_lock<std::shared_mutex> chain(chainMtx_);
     if (!block.verify(*this, utxos)) {
         return false;
     }
 
-    blocks.push_back(block);
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        blocks.push_back(block);
+    }
+    std::vector<OutPoint> spentByBlock;
     for (size_t i = 0; i < block.getBlockTransactions().size(); ++i) {
 
         //Supprime la transaction de la pool
         transactionPool.removeTransaction(block.getBlockTransactions()[i]);
 
+        //Indexe la transaction (la récompense de minage engage la hauteur du bloc : pas deux fois le même txid)
+        txIndex.try_emplace(block[i].getTxid(), TxLocation{block.getIndex(), static_cast<uint16_t>(i)});
+
         //itere sur les sortie pour les ajouter aux unspentoutputs
         for (size_t j = 0; j < block[i].getOutputs().size(); ++j) {
             const OutputReference outRef(block.getIndex(), i, j);
-            addUnspentOutput(block[i].getOutputs()[j].getPubKey(), outRef);
+            addUnspentOutput(block[i].getOutputs()[j], outRef);
         }
 
-        //itere sur les entrées pour les supprimer des unspentoutputs
-        for (const auto& input : block[i].getInputs()) {
-            deleteUnspentOutput(input.getOutput(*this).getPubKey(), input);
+        //itere sur les entrées pour les supprimer des unspentoutputs (un parent non confirmé est déjà indexé : bloc précédent ou plus haut dans celui-ci)
+        for (size_t k = 0; k < block[i].getInputs().size() && !block[i].isMiningReward(); ++k) {
+            const SpentOutput spent = block[i].resolveInput(k, *this);
+            deleteUnspentOutput(*spent.output, *spent.confirmed);
+            spentByBlock.push_back(spent.outPoint);
         }
+
+        //Enfants orphelins de cette transaction : ils peuvent maintenant être admis
+        admission.releaseOrphans(block[i]);
     }
 
+    //Transactions de la pool qui dépensaient les mêmes sorties autrement (et leurs descendants) : invalides désormais
+    transactionPool.removeConflicts(spentByBlock);
+
+    //Pool relue en attente de cette hauteur : revalidée par le thread d'admission, pas pendant la connexion du bloc
+    bool reloadPending;
+    {
+        std::lock_guard<std::mutex> lk(reloadMtx_);
+        reloadPending = !pendingReload_.txs.empty();
+    }
+    if (reloadPending) {
+        admission.post([this] { restoreMempoolIfReady(); });
+    }
+
+    //Prépare le modèle du prochain bloc : le mineur le reprend sans attendre
+    transactionPool.blockTemplate();
+
     //Nouveau bloc accepté (hors lock)
+    chain.unlock();
     if (onNewBlock) {
         try { onNewBlock(block); } catch(...) {}
     }
     return true;
 }
 
-double Blockchain::getWalletBalance(const PubKey& pubKey) const{
-    std::lock_guard<std::mutex> lk(mtx_);
-    double balance = 0.0;
-    
-    // Vérifier si le wallet existe avant d'accéder
-    auto it = utxos.find(pubKey);
-    if (it != utxos.end()) {
-        // Ajouter les sorties non dépensées
-        for (const auto& ref : it->second) {
-            const auto& tx = blocks[ref.getBlockIndex()][ref.getTxIndex()]; // accès interne sous lock
-            balance += tx.getOutputs()[ref.getOutputIndex()].getValue();
+bool Blockchain::saveMempool(const std::string& path) const {
+    // Toute la pool, dans l'ordre d'un bloc sans limite de taille : parents avant enfants, lue avec la hauteur qui la valide
+    uint32_t height = 0;
+    Hash tip;
+    std::vector<std::shared_ptr<const PoolEntry>> entries;
+    {
+        const auto chain = readLock();
+        height = size();
+        tip = height > 0 ? (*this)[height - 1].getHash() : Hash{};
+        entries = transactionPool.selectForBlock(std::numeric_limits<size_t>::max());
+    }
+    // Sérialisation, checksum et écriture hors du verrou : addBlock n'attend pas le disque
+    return MempoolFile::save(path, height, tip, entries);
+}
+
+bool Blockchain::loadMempool(const std::string& path) {
+    auto contents = MempoolFile::load(path);
+    if (!contents) {
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lk(reloadMtx_);
+        pendingReload_ = std::move(*contents);
+    }
+    admission.post([this] { restoreMempoolIfReady(); });
+    return true;
+}
+
+void Blockchain::restoreMempoolIfReady() {
+    std::vector<Transaction> txs;
+    {
+        std::lock_guard<std::mutex> lk(reloadMtx_);
+        if (pendingReload_.txs.empty() || size() < pendingReload_.height) {
+            return;
+        }
+        txs = std::move(pendingReload_.txs);
+        pendingReload_.txs.clear();
+        const Hash tip = pendingReload_.height > 0 ? (*this)[pendingReload_.height - 1].getHash() : Hash{};
+        if (!(tip == pendingReload_.tip)) {
+            std::cout << "Mempool discarded: saved on another chain." << std::endl;
+            return;
         }
     }
-    
-    return balance;
+    const size_t restored = transactionPool.restore(txs);
+    std::cout << "Mempool restored: " << restored << "/" << txs.size() << " transactions." << std::endl;
 }
 
 bool Blockchain::addAndBroadCastTransaction(const Transaction& tx) {
-
-    if (transactionPool.addTransaction(tx)) {
+    bool added;
+    {
+        const auto chain = readLock();
+        added = transactionPool.addTransaction(tx);
+    }
+    if (added) {
         network.buildFrameAndbroadcast(MsgType::BROADCAST_TX, tx);
+        admission.releaseOrphans(tx);
         return true;
     }
     return false;
@@ -3,13 +3,25 @@
 
 #include "Block.hpp"
 #include "network/NodeNetwork.hpp"
+#include "network/AdmissionQueue.hpp"
 #include "config.hpp"
 #include "transaction/TransactionPool.hpp"
+#include "transaction/MempoolFile.hpp"
+#include "transaction/WalletIndex.hpp"
 
 #include <mutex>
+#include <shared_mutex>
 #include <thread>
 #include <atomic>
 #include <functional>
+#include <optional>
+#include <unordered_map>
+
+/*Position d'une transaction confirmée dans la chaîne*/
+struct TxLocation {
+    uint32_t blockIndex;
+    uint16_t txIndex;
+};
 
 class Blockchain {
 private:
@@ -18,18 +30,50 @@ private:
     NodeNetwork network{*this};
     TransactionPool transactionPool{*this};//pool de transactions en attente
     UTXOs utxos;//output de transactions non dépensées (unspent transaction outputs)
-
+    WalletIndex wallets;//solde courant de chaque propriétaire, tenu à jour avec utxos
+    std::unordered_map<Hash, TxLocation> txIndex;//transactions confirmées par txid
+    mutable std::shared_mutex chainMtx_;//utxos, wallets et txIndex : écriture par addBlock, lecture par qui vérifie une transaction
     mutable std::mutex mtx_;
+
+    std::mutex reloadMtx_;
+    MempoolFile::Contents pendingReload_; // pool relue avant que la chaîne n'atteigne sa hauteur de sauvegarde
+
+    //transactions reçues des pairs : vérifiées par lots hors du thread réseau puis relayées (déclarée après la pool et la sauvegarde relue, donc arrêtée avant elles)
+    AdmissionQueue admission{
+        [this](const Transaction& tx) {
+            // Parent encore dans le lot (pas encore admis) : la signature sera vérifiée à l'admission
+            const auto spent = transactionPool.findSpentOutput(tx, 0);
+            return !spent || tx.verifySignature(spent->getPubKey());
+        },
+        [this](const Transaction& tx) {
+            if (transactionPool.addTransaction(tx)) return AdmissionQueue::Verdict::Accepted;
+            return transactionPool.hasMissingParents(tx) ? AdmissionQueue::Verdict::MissingParents : AdmissionQueue::Verdict::Rejected;
+        },
+        [this](const Transaction& tx, const PeerInfo& from) { network.relayTransaction(tx, from); },
+        &chainMtx_};
+
     std::atomic<bool> isMining_{false};
     double lastHashrateMHs{0.0};
     double lastTPS_{0.0};
 
     std::function<void(const Block&)> onNewBlock; // nouveau bloc accepté (local ou réseau)
 
-    /*Ajoute une sortie non dépensée à la liste*/
-    void addUnspentOutput(const PubKey& pubKey, const OutputReference& outputRef) {utxos[pubKey].insert(outputRef);}
-    /*Supprime une sortie non dépensée de la liste*/
-    void deleteUnspentOutput(const PubKey& pubKey, const OutputReference& outputRef) {utxos[pubKey].erase(outputRef);}
+    /*Réadmet la pool relue si la chaîne a rattrapé la hauteur de sauvegarde et contient son dernier bloc, l'écarte si ce bloc
+    diffère (sauvegarde d'une autre chaîne). Exécutée sur le thread d'admission, verrou de la chaîne en lecture*/
+    void restoreMempoolIfReady();
+
+    /*Ajoute une sortie non dépensée à la liste et crédite le solde du propriétaire (seul endroit où une clé reçue est internée)*/
+    void addUnspentOutput(const Output& output, const OutputReference& outputRef) {
+        const OwnerId owner = OwnerTable::instance().intern(output.getPubKey());
+        if (utxos[owner].insert(outputRef).second) wallets.credit(owner, output.getValue());
+    }
+    /*Supprime une sortie non dépensée de la liste et débite le solde du propriétaire*/
+    void deleteUnspentOutput(const Output& output, const OutputReference& outputRef) {
+        const auto owner = OwnerTable::instance().find(output.getPubKey());
+        if (!owner) return;
+        auto it = utxos.find(*owner);
+        if (it != utxos.end() && it->second.erase(outputRef) > 0) wallets.debit(*owner, output.getValue());
+    }
 
     double computeTPS_NoLock(uint32_t window = 10) const;
 public:
@@ -40,7 +84,18 @@ public:
 
     /*Retourne le nombre de blocs dans la blockchain*/
     uint32_t size() const { std::lock_guard<std::mutex> lk(mtx_); return (uint32_t)blocks.size(); }
-    double getWalletBalance(const PubKey& pubKey) const;
+    /*Retourne le solde d'un wallet en O(1) depuis l'index des soldes*/
+    Amount getWalletBalance(const PubKey& pubKey) const {
+        const auto owner = OwnerTable::instance().find(pubKey);
+        return owner ? wallets.getBalance(*owner) : 0;
+    }
+    /*Retourne le nombre de sorties non dépensées d'un wallet*/
+    uint32_t getWalletUtxoCount(const PubKey& pubKey) const {
+        const auto owner = OwnerTable::instance().find(pubKey);
+        return owner ? wallets.getUtxoCount(*owner) : 0;
+    }
+    /*Retourne l'entrée de l'index pour ce wallet : garder la référence permet de lire le solde sans aucun lock*/
+    const WalletBalance& trackWallet(const PubKey& pubKey) { return wallets.track(OwnerTable::instance().intern(pubKey)); }
     /*Retourne une référence constante sur le bloc à l'index donné*/
     const Block& operator[](const size_t index) const { std::lock_guard<std::mutex> lk(mtx_); return blocks[index]; }
 
@@ -49,7 +104,7 @@ public:
     /*Retourne un object Transactions prêt a etre ajouté dans un bloc*/
     const BlockTransactions getNewBlockTransactions(const PubKey& minerPubKey) const {return BlockTransactions(*this, transactionPool, minerPubKey);}
     /*Retourne le mining reward a un index donné*/
-    static const double getMiningRewardAt(uint32_t index);
+    static const Amount getMiningRewardAt(uint32_t index);
     /*Retourne la difficulté à un index donné en se basent sur le temps des blocks precedants l'index*/
     const Target getTargetAt(uint32_t index) const;
 
@@ -60,6 +115,15 @@ public:
     const NodeNetwork& getNetwork() const { return network; }
 
     const UTXOs& getUTXOs() const { return utxos; }
+    /*Position d'une transaction confirmée, recherchée par txid*/
+    std::optional<TxLocation> findTransaction(const Hash& txid) const {
+        auto it = txIndex.find(txid);
+        if (it == txIndex.end()) return std::nullopt;
+        return it->second;
+    }
+
+    /*Verrou de lecture de l'état de la chaîne (UTXOs, soldes, index) : aucun bloc n'est connecté tant qu'il est tenu*/
+    std::shared_lock<std::shared_mutex> readLock() const { return std::shared_lock<std::shared_mutex>(chainMtx_); }
 
     bool isMining() const { return isMining_; }
     double getLastHashrateMHs() const { return lastHashrateMHs; }
@@ -68,9 +132,19 @@ public:
 
 
     //Setters
-    /*Vérifie si le bloc est valide avant de l'ajouter à la blockchain et modifie la liste des sorties non dépensées*/
+    /*Vérifie si le bloc est valide avant de l'ajouter à la blockchain et modifie la liste des sorties non dépensées (verrou de la chaîne en écriture, relâché avant onNewBlock)*/
     bool addBlock(const Block& block);
     bool addAndBroadCastTransaction(const Transaction& tx);
+    /*Dépose une transaction reçue d'un pair dans la file d'admission (retour immédiat, relayée si acceptée)*/
+    bool submitTransaction(Transaction tx, const PeerInfo& from) { return admission.enqueue(std::move(tx), from); }
+    AdmissionQueue::Stats getAdmissionStats() const { return admission.getStats(); }
+    /*Sauvegarde les transactions en attente (à la fermeture et périodiquement). Verrou de la chaîne tenu le temps de lire la pool seulement*/
+    bool saveMempool(const std::string& path) const;
+    /*Relit une sauvegarde de la pool. Revalidée sur le thread d'admission si la chaîne a déjà la hauteur de la sauvegarde,
+    sinon dès qu'elle l'atteint (synchronisation avec les pairs au démarrage). False si absente ou illisible*/
+    bool loadMempool(const std::string& path);
+    /*Attend que les transactions reçues et la pool relue aient été traitées*/
+    void drainAdmission() { admission.drain(); }
     /**
      * Définit le callback à appeler lorsqu'un nouveau bloc est accepté.
     */
@@ -1,2 +1,17 @@
 #define LISTEN_PORT 8185
-// par défaut: 8185
\ No newline at end of file
+// par défaut: 8185
+
+// Capacité d'un bloc en octets sérialisés (transactions hors récompense de minage), propre à chaque réseau : -DMAX_BLOCK_BYTES=...
+#ifndef MAX_BLOCK_BYTES
+#define MAX_BLOCK_BYTES 1000000
+#endif
+
+// Mémoire maximale de la pool de transactions (au-delà : éviction des moins bien payées) : -DMAX_POOL_MEMORY=...
+#ifndef MAX_POOL_MEMORY
+#define MAX_POOL_MEMORY (300u << 20)
+#endif
+
+// Intervalle entre deux sauvegardes de la pool de transactions, aussi sauvegardée à la fermeture : -DMEMPOOL_SAVE_INTERVAL_S=...
+#ifndef MEMPOOL_SAVE_INTERVAL_S
+#define MEMPOOL_SAVE_INTERVAL_S 600
+#endif
@@ -0,0 +1,38 @@
+#include "cryptography/CryptoContext.hpp"
+
+#include <stdexcept>
+
+CryptoContext::CryptoContext()
+    : sign_(EVP_MD_CTX_new()), verify_(EVP_MD_CTX_new()) {
+    if (!sign_ || !verify_) {
+        EVP_MD_CTX_free(sign_);
+        EVP_MD_CTX_free(verify_);
+        throw std::runtime_error("Failed to create EVP_MD_CTX");
+    }
+}
+
+CryptoContext::~CryptoContext() {
+    EVP_MD_CTX_free(sign_);
+    EVP_MD_CTX_free(verify_);
+}
+
+CryptoContext& CryptoContext::local() {
+    thread_local CryptoContext ctx;
+    return ctx;
+}
+
+const EVP_MD* CryptoContext::sha256() {
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    // Implémentation explicite : évite la résolution implicite du provider à chaque opération
+    static EVP_MD* md = [] {
+        EVP_MD* fetched = EVP_MD_fetch(nullptr, "SHA256", nullptr);
+        if (!fetched) {
+            throw std::runtime_error("Failed to fetch SHA256");
+        }
+        return fetched;
+    }();
+    return md;
+#else
+    return EVP_sha256();
+#endif
+}
@@ -0,0 +1,37 @@
+#ifndef CRYPTO_CONTEXT_HPP
+#define CRYPTO_CONTEXT_HPP
+
+#include <openssl/evp.h>
+#include <openssl/opensslv.h>
+
+/**
+ * Contextes OpenSSL réutilisables (signature et vérification ECDSA), un jeu par thread.
+ * Les EVP_MD_CTX sont remis à zéro (EVP_MD_CTX_reset) entre deux opérations au lieu d'être
+ * alloués/libérés à chaque appel, et l'algorithme SHA-256 n'est résolu qu'une fois
+ * (EVP_MD_fetch sur OpenSSL 3, sinon EVP_sha256).
+ */
+class CryptoContext {
+public:
+    /*Contextes du thread courant (créés au premier appel, libérés à la fin du thread)*/
+    static CryptoContext& local();
+
+    /*Algorithme SHA-256 partagé (résolu une seule fois pour tout le processus)*/
+    static const EVP_MD* sha256();
+
+    /*Contexte de signature, remis à zéro*/
+    EVP_MD_CTX* sign() { EVP_MD_CTX_reset(sign_); return sign_; }
+    /*Contexte de vérification, remis à zéro*/
+    EVP_MD_CTX* verify() { EVP_MD_CTX_reset(verify_); return verify_; }
+
+    CryptoContext(const CryptoContext&) = delete;
+    CryptoContext& operator=(const CryptoContext&) = delete;
+
+private:
+    CryptoContext();
+    ~CryptoContext();
+
+    EVP_MD_CTX* sign_;
+    EVP_MD_CTX* verify_;
+};
+
+#endif // CRYPTO_CONTEXT_HPP
@@ -0,0 +1,164 @@
+#ifndef FIXED_BYTES_HPP
+#define FIXED_BYTES_HPP
+
+#include <array>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include <cereal/types/array.hpp>
+
+/**
+ * Valeur binaire de taille fixe (N octets), copiable trivialement : base de Hash et PubKey.
+ * Remplace std::string : pas d'allocation, comparaison mot par mot,
+ * et sérialisée comme N octets bruts (sans préfixe de longueur).
+ */
+template<size_t N>
+struct FixedBytes {
+    static constexpr size_t SIZE = N;
+
+    std::array<uint8_t, SIZE> bytes{};
+
+    constexpr uint8_t operator[](size_t i) const { return bytes[i]; }
+    constexpr uint8_t& operator[](size_t i) { return bytes[i]; }
+
+    constexpr size_t size() const { return SIZE; }
+    uint8_t* data() { return bytes.data(); }
+    const uint8_t* data() const { return bytes.data(); }
+    constexpr auto begin() const { return bytes.begin(); }
+    constexpr auto end() const { return bytes.end(); }
+
+    /*Vrai si tous les octets sont nuls (hash précédent du bloc genesis)*/
+    bool isZero() const { return *this == FixedBytes{}; }
+
+    // Comparaison mot par mot : le compilateur la réduit à quelques instructions SIMD
+    friend bool operator==(const FixedBytes& a, const FixedBytes& b) {
+        if constexpr (N % sizeof(uint64_t) == 0) {
+            uint64_t wa[N / 8], wb[N / 8];
+            std::memcpy(wa, a.bytes.data(), N);
+            std::memcpy(wb, b.bytes.data(), N);
+            uint64_t diff = 0;
+            for (size_t i = 0; i < N / 8; ++i) diff |= wa[i] ^ wb[i];
+            return diff == 0;
+        } else {
+            return std::memcmp(a.bytes.data(), b.bytes.data(), N) == 0;
+        }
+    }
+    friend std::strong_ordering operator<=>(const FixedBytes& a, const FixedBytes& b) {
+        const int cmp = std::memcmp(a.bytes.data(), b.bytes.data(), SIZE);
+        return cmp < 0 ? std::strong_ordering::less : cmp > 0 ? std::strong_ordering::greater : std::strong_ordering::equal;
+    }
+
+    /*Représentation hexadécimale (2N caractères)*/
+    constexpr std::array<char, 2 * SIZE> toHexChars() const {
+        constexpr char digits[] = "0123456789abcdef";
+        std::array<char, 2 * SIZE> hex{};
+        for (size_t i = 0; i < SIZE; ++i) {
+            hex[2 * i] = digits[bytes[i] >> 4];
+            hex[2 * i + 1] = digits[bytes[i] & 0x0F];
+        }
+        return hex;
+    }
+    std::string toHex() const {
+        const auto hex = toHexChars();
+        return std::string(hex.begin(), hex.end());
+    }
+
+    /*Construit la valeur depuis 2N caractères hexadécimaux (utilisable à la compilation)*/
+    static constexpr FixedBytes fromHex(std::string_view hex) {
+        if (hex.size() != 2 * SIZE) {
+            throw std::invalid_argument("Invalid hex length");
+        }
+        auto nibble = [](char c) -> uint8_t {
+            if (c >= '0' && c <= '9') return static_cast<uint8_t>(c - '0');
+            if (c >= 'a' && c <= 'f') return static_cast<uint8_t>(c - 'a' + 10);
+            if (c >= 'A' && c <= 'F') return static_cast<uint8_t>(c - 'A' + 10);
+            throw std::invalid_argument("Invalid hex character");
+        };
+        FixedBytes value;
+        for (size_t i = 0; i < SIZE; ++i) {
+            value.bytes[i] = static_cast<uint8_t>((nibble(hex[2 * i]) << 4) | nibble(hex[2 * i + 1]));
+        }
+        return value;
+    }
+
+    template<class Archive>
+    void serialize(Archive& ar) {
+        ar(bytes);
+    }
+};
+
+/*Empreinte SHA-256*/
+using Hash = FixedBytes<32>;
+/*Clé publique secp256k1 compressée : préfixe 0x02/0x03 (parité de Y) + coordonnée X*/
+using PubKey = FixedBytes<33>;
+
+static_assert(sizeof(Hash) == Hash::SIZE, "Hash must be exactly 32 bytes");
+static_assert(sizeof(PubKey) == PubKey::SIZE, "PubKey must be exactly 33 bytes");
+static_assert(std::is_trivially_copyable_v<Hash>, "Hash must be trivially copyable");
+
+namespace fixed_bytes_detail {
+    /*Clé tirée au hasard une fois par processus : un pair ne peut pas prévoir la case d'une clé qu'il choisit*/
+    inline const std::array<uint64_t, 2>& hashKey() {
+        static const std::array<uint64_t, 2> key = [] {
+            std::random_device rd;
+            return std::array<uint64_t, 2>{(static_cast<uint64_t>(rd()) << 32) ^ rd(), (static_cast<uint64_t>(rd()) << 32) ^ rd()};
+        }();
+        return key;
+    }
+
+    /*SipHash-1-3 de data avec la clé du processus*/
+    inline uint64_t sipHash13(const uint8_t* data, size_t len) {
+        const auto& k = hashKey();
+        uint64_t v0 = k[0] ^ 0x736f6d6570736575ull;
+        uint64_t v1 = k[1] ^ 0x646f72616e646f6dull;
+        uint64_t v2 = k[0] ^ 0x6c7967656e657261ull;
+        uint64_t v3 = k[1] ^ 0x7465646279746573ull;
+        auto round = [&] {
+            v0 += v1; v1 = std::rotl(v1, 13); v1 ^= v0; v0 = std::rotl(v0, 32);
+            v2 += v3; v3 = std::rotl(v3, 16); v3 ^= v2;
+            v0 += v3; v3 = std::rotl(v3, 21); v3 ^= v0;
+            v2 += v1; v1 = std::rotl(v1, 17); v1 ^= v2; v2 = std::rotl(v2, 32);
+        };
+        size_t i = 0;
+        for (; i + 8 <= len; i += 8) {
+            uint64_t m;
+            std::memcpy(&m, data + i, 8);
+            v3 ^= m;
+            round();
+            v0 ^= m;
+        }
+        uint64_t last = static_cast<uint64_t>(len) << 56;
+        for (size_t b = 0; i + b < len; ++b) {
+            last |= static_cast<uint64_t>(data[i + b]) << (8 * b);
+        }
+        v3 ^= last;
+        round();
+        v0 ^= last;
+        v2 ^= 0xff;
+        round();
+        round();
+        round();
+        return v0 ^ v1 ^ v2 ^ v3;
+    }
+}
+
+// Les clés des tables (txids, sorties, pairs) viennent du réseau : hachées avec une clé secrète par processus
+// pour qu'un pair ne puisse pas fabriquer des collisions et dégrader les tables en listes
+namespace std {
+    template<size_t N> struct hash<FixedBytes<N>> {
+        size_t operator()(const FixedBytes<N>& value) const noexcept {
+            return static_cast<size_t>(fixed_bytes_detail::sipHash13(value.bytes.data(), N));
+        }
+    };
+}
+
+#endif // FIXED_BYTES_HPP
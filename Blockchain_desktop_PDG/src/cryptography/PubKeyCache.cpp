@@ -0,0 +1,52 @@
+#include "cryptography/PubKeyCache.hpp"
+
+PubKeyCache& PubKeyCache::instance() {
+    static PubKeyCache cache;
+    return cache;
+}
+
+crypto::PubKeyHandle PubKeyCache::get(const PubKey& pubKey) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(pubKey);
+        if (it != index_.end()) {
+            lru_.splice(lru_.begin(), lru_, it->second);
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            return it->second->second;
+        }
+    }
+    misses_.fetch_add(1, std::memory_order_relaxed);
+
+    // Décodage hors lock : deux threads peuvent décoder la même clé, le second réutilise l'entrée du premier
+    crypto::PubKeyHandle decoded = crypto::decodePubKey(pubKey);
+    if (!decoded || capacity_ == 0) {
+        return decoded; // clé invalide : pas mise en cache
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(pubKey);
+    if (it != index_.end()) {
+        lru_.splice(lru_.begin(), lru_, it->second);
+        return it->second->second;
+    }
+    lru_.emplace_front(pubKey, decoded);
+    index_.emplace(pubKey, lru_.begin());
+    if (lru_.size() > capacity_) {
+        index_.erase(lru_.back().first);
+        lru_.pop_back();
+    }
+    return decoded;
+}
+
+size_t PubKeyCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lru_.size();
+}
+
+void PubKeyCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lru_.clear();
+    index_.clear();
+    hits_.store(0, std::memory_order_relaxed);
+    misses_.store(0, std::memory_order_relaxed);
+}
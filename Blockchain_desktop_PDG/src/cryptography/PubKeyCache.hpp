@@ -0,0 +1,45 @@
+#ifndef PUBKEY_CACHE_HPP
+#define PUBKEY_CACHE_HPP
+
+#include "cryptography/crypto.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * Cache LRU des clés publiques décodées (EVP_PKEY), indexé par PubKey (point compressé de 33 octets).
+ * Décompresser le point et construire l'EVP_PKEY (EVP_PKEY_fromdata) coûte une part notable
+ * d'une vérification ; un même wallet signe beaucoup de transactions, sa clé n'est donc décodée qu'une fois.
+ */
+class PubKeyCache {
+public:
+    explicit PubKeyCache(size_t capacity = 4096) : capacity_(capacity) {}
+
+    /*Cache partagé par tout le noeud*/
+    static PubKeyCache& instance();
+
+    /*Retourne la clé décodée (depuis le cache ou en la décodant). nullptr si la clé est invalide*/
+    crypto::PubKeyHandle get(const PubKey& pubKey);
+
+    size_t size() const;
+    uint64_t getHits() const { return hits_.load(std::memory_order_relaxed); }
+    uint64_t getMisses() const { return misses_.load(std::memory_order_relaxed); }
+    void clear();
+
+private:
+    using Entry = std::pair<PubKey, crypto::PubKeyHandle>;
+
+    const size_t capacity_;
+    std::list<Entry> lru_; // les plus récemment utilisées en tête
+    std::unordered_map<PubKey, std::list<Entry>::iterator> index_;
+    mutable std::mutex mutex_;
+
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+};
+
+#endif // PUBKEY_CACHE_HPP
@@ -0,0 +1,293 @@
+#include "cryptography/Sha256.hpp"
+#include "cryptography/Sha256Backends.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#define SHA256_X86 1
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define SHA256_X86 1
+#endif
+
+namespace sha256::detail {
+
+    const uint32_t K[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+    };
+
+    const uint32_t INITIAL_STATE[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+    };
+
+    namespace {
+        inline uint32_t rotr(uint32_t x, int n) { return (x >> n) | (x << (32 - n)); }
+
+        inline uint32_t loadBE32(const uint8_t* p) {
+            return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+        }
+    }
+
+    void transformPortable(uint32_t* state, const uint8_t* blocks, size_t nBlocks) {
+        uint32_t w[64];
+        for (size_t b = 0; b < nBlocks; ++b, blocks += BLOCK_SIZE) {
+            for (int t = 0; t < 16; ++t) {
+                w[t] = loadBE32(blocks + 4 * t);
+            }
+            for (int t = 16; t < 64; ++t) {
+                const uint32_t s0 = rotr(w[t - 15], 7) ^ rotr(w[t - 15], 18) ^ (w[t - 15] >> 3);
+                const uint32_t s1 = rotr(w[t - 2], 17) ^ rotr(w[t - 2], 19) ^ (w[t - 2] >> 10);
+                w[t] = w[t - 16] + s0 + w[t - 7] + s1;
+            }
+
+            uint32_t a = state[0], b2 = state[1], c = state[2], d = state[3];
+            uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+            for (int t = 0; t < 64; ++t) {
+                const uint32_t S1 = rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25);
+                const uint32_t ch = (e & f) ^ (~e & g);
+                const uint32_t t1 = h + S1 + ch + K[t] + w[t];
+                const uint32_t S0 = rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22);
+                const uint32_t maj = (a & b2) ^ (a & c) ^ (b2 & c);
+                const uint32_t t2 = S0 + maj;
+                h = g; g = f; f = e; e = d + t1;
+                d = c; c = b2; b2 = a; a = t1 + t2;
+            }
+            state[0] += a; state[1] += b2; state[2] += c; state[3] += d;
+            state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+        }
+    }
+
+}
+
+namespace sha256 {
+
+    namespace {
+        using namespace detail;
+
+        struct CpuFeatures {
+            bool shaNi = false;
+            bool avx2 = false;
+        };
+
+        CpuFeatures detectCpu() {
+            CpuFeatures features;
+#if defined(SHA256_X86)
+            unsigned int regs1[4] = {0, 0, 0, 0};
+            unsigned int regs7[4] = {0, 0, 0, 0};
+#if defined(_MSC_VER) && !defined(__clang__)
+            int info[4];
+            __cpuid(info, 0);
+            const unsigned int maxLeaf = static_cast<unsigned int>(info[0]);
+            __cpuidex(info, 1, 0);
+            for (int i = 0; i < 4; ++i) regs1[i] = static_cast<unsigned int>(info[i]);
+            if (maxLeaf >= 7) {
+                __cpuidex(info, 7, 0);
+                for (int i = 0; i < 4; ++i) regs7[i] = static_cast<unsigned int>(info[i]);
+            }
+#else
+            const unsigned int maxLeaf = __get_cpuid_max(0, nullptr);
+            __get_cpuid(1, &regs1[0], &regs1[1], &regs1[2], &regs1[3]);
+            if (maxLeaf >= 7) {
+                __get_cpuid_count(7, 0, &regs7[0], &regs7[1], &regs7[2], &regs7[3]);
+            }
+#endif
+            const bool ssse3 = regs1[2] & (1u << 9);
+            const bool sse41 = regs1[2] & (1u << 19);
+            const bool osxsave = regs1[2] & (1u << 27);
+            const bool avx = regs1[2] & (1u << 28);
+
+            // AVX2 exige aussi que l'OS sauvegarde les registres YMM (XCR0 bits 1 et 2)
+            bool ymmEnabled = false;
+            if (osxsave && avx) {
+#if defined(_MSC_VER) && !defined(__clang__)
+                const unsigned long long xcr0 = _xgetbv(0);
+#else
+                unsigned int lo = 0, hi = 0;
+                __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+                const unsigned long long xcr0 = (static_cast<unsigned long long>(hi) << 32) | lo;
+#endif
+                ymmEnabled = (xcr0 & 0x6) == 0x6;
+            }
+
+            features.shaNi = kShaNiCompiled && ssse3 && sse41 && (regs7[1] & (1u << 29));
+            features.avx2 = kAvx2Compiled && ymmEnabled && (regs7[1] & (1u << 5));
+#endif
+            return features;
+        }
+
+        const CpuFeatures& cpu() {
+            static const CpuFeatures features = detectCpu();
+            return features;
+        }
+
+        Backend bestSupported() {
+            if (cpu().shaNi) return Backend::ShaNi;
+            if (cpu().avx2) return Backend::Avx2;
+            return Backend::Portable;
+        }
+
+        std::atomic<Backend>& current() {
+            static std::atomic<Backend> backend{bestSupported()};
+            return backend;
+        }
+
+        inline void storeBE32(uint8_t* p, uint32_t v) {
+            p[0] = static_cast<uint8_t>(v >> 24);
+            p[1] = static_cast<uint8_t>(v >> 16);
+            p[2] = static_cast<uint8_t>(v >> 8);
+            p[3] = static_cast<uint8_t>(v);
+        }
+
+        inline void storeBE64(uint8_t* p, uint64_t v) {
+            storeBE32(p, static_cast<uint32_t>(v >> 32));
+            storeBE32(p + 4, static_cast<uint32_t>(v));
+        }
+
+        /*Remplit le(s) dernier(s) bloc(s) : reste du message, 0x80, zéros, longueur en bits. Retourne 1 ou 2 blocs*/
+        size_t buildTail(uint8_t* tail, const uint8_t* rest, size_t restLen, uint64_t totalLen) {
+            const size_t nBlocks = restLen + 9 <= BLOCK_SIZE ? 1 : 2;
+            std::memset(tail, 0, nBlocks * BLOCK_SIZE);
+            if (restLen > 0) std::memcpy(tail, rest, restLen);
+            tail[restLen] = 0x80;
+            storeBE64(tail + nBlocks * BLOCK_SIZE - 8, totalLen * 8);
+            return nBlocks;
+        }
+    }
+
+    bool isSupported(Backend backend) {
+        switch (backend) {
+            case Backend::Portable: return true;
+            case Backend::Avx2: return cpu().avx2;
+            case Backend::ShaNi: return cpu().shaNi;
+        }
+        return false;
+    }
+
+    Backend activeBackend() {
+        return current().load(std::memory_order_relaxed);
+    }
+
+    bool setBackend(Backend backend) {
+        if (!isSupported(backend)) return false;
+        current().store(backend, std::memory_order_relaxed);
+        return true;
+    }
+
+    const char* backendName(Backend backend) {
+        switch (backend) {
+            case Backend::Portable: return "portable";
+            case Backend::Avx2: return "avx2";
+            case Backend::ShaNi: return "sha-ni";
+        }
+        return "unknown";
+    }
+
+    // Un seul message : SHA-NI si disponible, sinon la version portable (AVX2 n'accélère que les lots)
+    Hasher::Hasher()
+        : transform_(activeBackend() == Backend::ShaNi ? transformShaNi : transformPortable) {
+        std::memcpy(state_, INITIAL_STATE, sizeof(state_));
+    }
+
+    Hasher& Hasher::update(std::span<const uint8_t> data) {
+        const uint8_t* p = data.data();
+        size_t n = data.size();
+        totalLen_ += n;
+
+        if (bufferLen_ > 0) {
+            const size_t take = std::min(n, BLOCK_SIZE - bufferLen_);
+            std::memcpy(buffer_ + bufferLen_, p, take);
+            bufferLen_ += take;
+            p += take;
+            n -= take;
+            if (bufferLen_ < BLOCK_SIZE) {
+                return *this;
+            }
+            transform_(state_, buffer_, 1);
+            bufferLen_ = 0;
+        }
+        if (n >= BLOCK_SIZE) {
+            const size_t nBlocks = n / BLOCK_SIZE;
+            transform_(state_, p, nBlocks);
+            p += nBlocks * BLOCK_SIZE;
+            n -= nBlocks * BLOCK_SIZE;
+        }
+        if (n > 0) {
+            std::memcpy(buffer_, p, n);
+            bufferLen_ = n;
+        }
+        return *this;
+    }
+
+    void Hasher::finalize(std::span<uint8_t, DIGEST_SIZE> out) {
+        uint8_t tail[2 * BLOCK_SIZE];
+        const size_t nBlocks = buildTail(tail, buffer_, bufferLen_, totalLen_);
+        transform_(state_, tail, nBlocks);
+        for (int i = 0; i < 8; ++i) {
+            storeBE32(out.data() + 4 * i, state_[i]);
+        }
+    }
+
+    void hash(std::span<const uint8_t> data, std::span<uint8_t, DIGEST_SIZE> out) {
+        Hasher().update(data).finalize(out);
+    }
+
+    void hashMany(std::span<const std::span<const uint8_t>> messages, uint8_t* out) {
+        size_t i = 0;
+        if (activeBackend() == Backend::Avx2) {
+            // Paquets de 8 messages de même longueur : une lane AVX2 par message
+            while (i + 8 <= messages.size()) {
+                const size_t len = messages[i].size();
+                bool sameLength = true;
+                for (size_t lane = 1; lane < 8; ++lane) {
+                    sameLength = sameLength && messages[i + lane].size() == len;
+                }
+                if (!sameLength) {
+                    hash(messages[i], std::span<uint8_t, DIGEST_SIZE>(out + i * DIGEST_SIZE, DIGEST_SIZE));
+                    ++i;
+                    continue;
+                }
+
+                uint32_t states[8][8];
+                const uint8_t* ptrs[8];
+                const size_t nFull = len / BLOCK_SIZE;
+                for (size_t lane = 0; lane < 8; ++lane) {
+                    std::memcpy(states[lane], INITIAL_STATE, sizeof(INITIAL_STATE));
+                    ptrs[lane] = messages[i + lane].data();
+                }
+                if (nFull > 0) {
+                    transform8Avx2(states, ptrs, nFull);
+                }
+
+                uint8_t tails[8][2 * BLOCK_SIZE];
+                size_t nTail = 0;
+                for (size_t lane = 0; lane < 8; ++lane) {
+                    nTail = buildTail(tails[lane], messages[i + lane].data() + nFull * BLOCK_SIZE,
+                                      len - nFull * BLOCK_SIZE, len);
+                    ptrs[lane] = tails[lane];
+                }
+                transform8Avx2(states, ptrs, nTail);
+
+                for (size_t lane = 0; lane < 8; ++lane) {
+                    for (int w = 0; w < 8; ++w) {
+                        storeBE32(out + (i + lane) * DIGEST_SIZE + 4 * w, states[lane][w]);
+                    }
+                }
+                i += 8;
+            }
+        }
+        for (; i < messages.size(); ++i) {
+            hash(messages[i], std::span<uint8_t, DIGEST_SIZE>(out + i * DIGEST_SIZE, DIGEST_SIZE));
+        }
+    }
+
+}
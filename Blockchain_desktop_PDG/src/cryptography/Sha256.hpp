@@ -0,0 +1,61 @@
+#ifndef SHA256_HPP
+#define SHA256_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+/**
+ * Implémentation SHA-256 interne, utilisée par crypto::hashData.
+ * Trois back ends, choisis au démarrage selon le CPU (CPUID) :
+ *  - ShaNi    : instructions SHA d'Intel/AMD (un message à la fois, le plus rapide)
+ *  - Avx2     : 8 messages hachés en parallèle dans les lanes AVX2 (hashMany)
+ *  - Portable : C++ pur, toutes plateformes
+ */
+namespace sha256 {
+
+    constexpr size_t DIGEST_SIZE = 32;
+    constexpr size_t BLOCK_SIZE = 64;
+
+    enum class Backend : uint8_t {
+        Portable = 0,
+        Avx2 = 1,
+        ShaNi = 2,
+    };
+
+    /*Vrai si le back end est compilé et supporté par le CPU courant*/
+    bool isSupported(Backend backend);
+    /*Back end utilisé actuellement (le meilleur supporté, sauf si forcé par setBackend)*/
+    Backend activeBackend();
+    /*Force un back end (tests, benchmarks). Retourne false s'il n'est pas supporté*/
+    bool setBackend(Backend backend);
+    const char* backendName(Backend backend);
+
+    /*Hachage incrémental*/
+    class Hasher {
+    public:
+        Hasher();
+
+        Hasher& update(std::span<const uint8_t> data);
+        void finalize(std::span<uint8_t, DIGEST_SIZE> out);
+
+    private:
+        using Transform = void (*)(uint32_t* state, const uint8_t* blocks, size_t nBlocks);
+
+        Transform transform_;
+        uint32_t state_[8];
+        uint8_t buffer_[BLOCK_SIZE];
+        size_t bufferLen_ = 0;
+        uint64_t totalLen_ = 0;
+    };
+
+    /*SHA-256 de data dans out*/
+    void hash(std::span<const uint8_t> data, std::span<uint8_t, DIGEST_SIZE> out);
+
+    /*Hache plusieurs messages ; out reçoit messages.size() * DIGEST_SIZE octets.
+    Les messages de même longueur sont traités 8 par 8 avec le back end Avx2*/
+    void hashMany(std::span<const std::span<const uint8_t>> messages, uint8_t* out);
+
+}
+
+#endif // SHA256_HPP
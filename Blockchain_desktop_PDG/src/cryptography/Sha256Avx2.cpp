@@ -0,0 +1,96 @@
+// Back end AVX2 : 8 messages en parallèle, compilé avec -mavx2 (voir CMakeLists.txt), utilisé seulement si le CPU le supporte
+#include "cryptography/Sha256Backends.hpp"
+
+#include <cstring>
+
+#if ((defined(__x86_64__) || defined(__i386__)) && defined(__AVX2__)) \
+    || (defined(_MSC_VER) && !defined(__clang__) && (defined(_M_X64) || defined(_M_IX86)))
+#define SHA256_AVX2_AVAILABLE 1
+#include <immintrin.h>
+#endif
+
+namespace sha256::detail {
+
+#if defined(SHA256_AVX2_AVAILABLE)
+
+    const bool kAvx2Compiled = true;
+
+    namespace {
+        inline __m256i rotr(__m256i x, int n) {
+            return _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - n));
+        }
+        inline __m256i add(__m256i a, __m256i b) { return _mm256_add_epi32(a, b); }
+        inline __m256i xor3(__m256i a, __m256i b, __m256i c) { return _mm256_xor_si256(_mm256_xor_si256(a, b), c); }
+
+        // Mot t (big-endian) de chacune des 8 lanes
+        inline __m256i loadWord(const uint8_t* const blocks[8], size_t offset) {
+            const __m256i byteSwap = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                                                      3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+            uint32_t words[8];
+            for (int lane = 0; lane < 8; ++lane) {
+                std::memcpy(&words[lane], blocks[lane] + offset, 4);
+            }
+            return _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(words)), byteSwap);
+        }
+    }
+
+    void transform8Avx2(uint32_t states[8][8], const uint8_t* const blocks[8], size_t nBlocks) {
+        // Transpose l'état : s[i] contient le mot i des 8 lanes
+        __m256i s[8];
+        for (int i = 0; i < 8; ++i) {
+            s[i] = _mm256_setr_epi32(states[0][i], states[1][i], states[2][i], states[3][i],
+                                     states[4][i], states[5][i], states[6][i], states[7][i]);
+        }
+
+        const uint8_t* ptrs[8];
+        for (int lane = 0; lane < 8; ++lane) ptrs[lane] = blocks[lane];
+
+        __m256i w[64];
+        for (size_t b = 0; b < nBlocks; ++b) {
+            for (int t = 0; t < 16; ++t) {
+                w[t] = loadWord(ptrs, 4 * t);
+            }
+            for (int t = 16; t < 64; ++t) {
+                const __m256i s0 = xor3(rotr(w[t - 15], 7), rotr(w[t - 15], 18), _mm256_srli_epi32(w[t - 15], 3));
+                const __m256i s1 = xor3(rotr(w[t - 2], 17), rotr(w[t - 2], 19), _mm256_srli_epi32(w[t - 2], 10));
+                w[t] = add(add(w[t - 16], s0), add(w[t - 7], s1));
+            }
+
+            __m256i a = s[0], bb = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+            for (int t = 0; t < 64; ++t) {
+                const __m256i S1 = xor3(rotr(e, 6), rotr(e, 11), rotr(e, 25));
+                const __m256i ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+                const __m256i t1 = add(add(add(h, S1), add(ch, _mm256_set1_epi32(static_cast<int>(K[t])))), w[t]);
+                const __m256i S0 = xor3(rotr(a, 2), rotr(a, 13), rotr(a, 22));
+                const __m256i maj = _mm256_or_si256(_mm256_and_si256(a, bb), _mm256_and_si256(c, _mm256_or_si256(a, bb)));
+                const __m256i t2 = add(S0, maj);
+                h = g; g = f; f = e; e = add(d, t1);
+                d = c; c = bb; bb = a; a = add(t1, t2);
+            }
+            s[0] = add(s[0], a); s[1] = add(s[1], bb); s[2] = add(s[2], c); s[3] = add(s[3], d);
+            s[4] = add(s[4], e); s[5] = add(s[5], f); s[6] = add(s[6], g); s[7] = add(s[7], h);
+
+            for (int lane = 0; lane < 8; ++lane) ptrs[lane] += 64;
+        }
+
+        for (int i = 0; i < 8; ++i) {
+            alignas(32) uint32_t lanes[8];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), s[i]);
+            for (int lane = 0; lane < 8; ++lane) states[lane][i] = lanes[lane];
+        }
+    }
+
+#else
+
+    const bool kAvx2Compiled = false;
+
+    void transform8Avx2(uint32_t states[8][8], const uint8_t* const blocks[8], size_t nBlocks) {
+        // Jamais sélectionné (isSupported(Avx2) == false) ; repli par sécurité
+        for (int lane = 0; lane < 8; ++lane) {
+            transformPortable(states[lane], blocks[lane], nBlocks);
+        }
+    }
+
+#endif
+
+}
@@ -0,0 +1,27 @@
+#ifndef SHA256_BACKENDS_HPP
+#define SHA256_BACKENDS_HPP
+
+// Interne à l'implémentation SHA-256 : transformations de blocs de chaque back end
+
+#include <cstddef>
+#include <cstdint>
+
+namespace sha256::detail {
+
+    extern const uint32_t K[64];
+    extern const uint32_t INITIAL_STATE[8];
+
+    /*Compresse nBlocks blocs de 64 octets dans state*/
+    void transformPortable(uint32_t* state, const uint8_t* blocks, size_t nBlocks);
+
+    /*Version SHA-NI ; kShaNiCompiled est false si le fichier n'a pas pu être compilé avec -msha*/
+    extern const bool kShaNiCompiled;
+    void transformShaNi(uint32_t* state, const uint8_t* blocks, size_t nBlocks);
+
+    /*8 messages en parallèle : states[lane] et blocks[lane] (nBlocks blocs consécutifs par lane)*/
+    extern const bool kAvx2Compiled;
+    void transform8Avx2(uint32_t states[8][8], const uint8_t* const blocks[8], size_t nBlocks);
+
+}
+
+#endif // SHA256_BACKENDS_HPP
@@ -0,0 +1,87 @@
+// Back end SHA-NI : compilé avec -msha -msse4.1 (voir CMakeLists.txt), utilisé seulement si le CPU le supporte
+#include "cryptography/Sha256Backends.hpp"
+
+#include <utility>
+
+#if ((defined(__x86_64__) || defined(__i386__)) && defined(__SHA__) && defined(__SSE4_1__)) \
+    || (defined(_MSC_VER) && !defined(__clang__) && (defined(_M_X64) || defined(_M_IX86)))
+#define SHA256_SHANI_AVAILABLE 1
+#include <immintrin.h>
+#endif
+
+namespace sha256::detail {
+
+#if defined(SHA256_SHANI_AVAILABLE)
+
+    const bool kShaNiCompiled = true;
+
+    namespace {
+        // Un groupe de 4 rondes : G = index du groupe (0..15), msg[] = fenêtre glissante des 16 derniers mots
+        template<int G>
+        inline void rounds4(__m128i& state0, __m128i& state1, __m128i (&msg)[4]) {
+            __m128i m = _mm_add_epi32(msg[G % 4], _mm_loadu_si128(reinterpret_cast<const __m128i*>(&K[4 * G])));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, m);
+            if constexpr (G >= 3 && G <= 14) {
+                const __m128i tmp = _mm_alignr_epi8(msg[G % 4], msg[(G + 3) % 4], 4);
+                msg[(G + 1) % 4] = _mm_add_epi32(msg[(G + 1) % 4], tmp);
+                msg[(G + 1) % 4] = _mm_sha256msg2_epu32(msg[(G + 1) % 4], msg[G % 4]);
+            }
+            m = _mm_shuffle_epi32(m, 0x0E);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, m);
+            if constexpr (G >= 1 && G <= 12) {
+                msg[(G + 3) % 4] = _mm_sha256msg1_epu32(msg[(G + 3) % 4], msg[G % 4]);
+            }
+        }
+
+        template<int... G>
+        inline void allRounds(__m128i& state0, __m128i& state1, __m128i (&msg)[4], std::integer_sequence<int, G...>) {
+            (rounds4<G>(state0, state1, msg), ...);
+        }
+    }
+
+    void transformShaNi(uint32_t* state, const uint8_t* blocks, size_t nBlocks) {
+        const __m128i byteSwap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+        // Réorganise l'état (a..h) en ABEF / CDGH, format attendu par sha256rnds2
+        __m128i tmp = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[0]));
+        __m128i state1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[4]));
+        tmp = _mm_shuffle_epi32(tmp, 0xB1);             // CDAB
+        state1 = _mm_shuffle_epi32(state1, 0x1B);       // EFGH
+        __m128i state0 = _mm_alignr_epi8(tmp, state1, 8); // ABEF
+        state1 = _mm_blend_epi16(state1, tmp, 0xF0);    // CDGH
+
+        for (size_t b = 0; b < nBlocks; ++b, blocks += 64) {
+            const __m128i abefSave = state0;
+            const __m128i cdghSave = state1;
+
+            __m128i msg[4];
+            for (int i = 0; i < 4; ++i) {
+                msg[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(blocks + 16 * i)), byteSwap);
+            }
+            allRounds(state0, state1, msg, std::make_integer_sequence<int, 16>{});
+
+            state0 = _mm_add_epi32(state0, abefSave);
+            state1 = _mm_add_epi32(state1, cdghSave);
+        }
+
+        tmp = _mm_shuffle_epi32(state0, 0x1B);          // FEBA
+        state1 = _mm_shuffle_epi32(state1, 0xB1);       // DCHG
+        state0 = _mm_blend_epi16(tmp, state1, 0xF0);    // DCBA
+        state1 = _mm_alignr_epi8(state1, tmp, 8);       // HGFE
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[0]), state0);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[4]), state1);
+    }
+
+#else
+
+    const bool kShaNiCompiled = false;
+
+    void transformShaNi(uint32_t* state, const uint8_t* blocks, size_t nBlocks) {
+        // Jamais sélectionné (isSupported(ShaNi) == false) ; repli par sécurité
+        transformPortable(state, blocks, nBlocks);
+    }
+
+#endif
+
+}
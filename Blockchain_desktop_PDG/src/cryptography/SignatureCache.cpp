@@ -0,0 +1,81 @@
+#include "cryptography/SignatureCache.hpp"
+#include "cryptography/Sha256.hpp"
+
+#include <algorithm>
+
+SignatureCache::SignatureCache(size_t maxEntries)
+    : maxPerShard_(std::max<size_t>(1, maxEntries / kShards)) {}
+
+SignatureCache& SignatureCache::instance() {
+    static SignatureCache cache;
+    return cache;
+}
+
+Hash SignatureCache::makeKey(const Hash& sigHash, const PubKey& pubKey, const Signature& signature) {
+    // Haché en flux, sans tampon intermédiaire ; les longueurs évitent qu'une concaténation ambiguë donne la même clé
+    const uint8_t pubKeyLen = static_cast<uint8_t>(pubKey.size());
+    const uint8_t signatureLen = static_cast<uint8_t>(signature.size());
+    sha256::Hasher hasher;
+    hasher.update(sigHash.bytes)
+          .update({&pubKeyLen, 1})
+          .update(pubKey.bytes)
+          .update({&signatureLen, 1})
+          .update(crypto::asBytes(signature));
+    Hash key;
+    hasher.finalize(key.bytes);
+    return key;
+}
+
+bool SignatureCache::contains(const Hash& sigHash, const PubKey& pubKey, const Signature& signature) {
+    const Hash key = makeKey(sigHash, pubKey, signature);
+    Shard& shard = shardFor(key);
+    bool found;
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        found = shard.entries.count(key) > 0;
+    }
+    (found ? hits_ : misses_).fetch_add(1, std::memory_order_relaxed);
+    return found;
+}
+
+void SignatureCache::insert(const Hash& sigHash, const PubKey& pubKey, const Signature& signature) {
+    const Hash key = makeKey(sigHash, pubKey, signature);
+    Shard& shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (!shard.entries.insert(key).second) {
+        return;
+    }
+    shard.order.push_back(key);
+    insertions_.fetch_add(1, std::memory_order_relaxed);
+
+    while (shard.entries.size() > maxPerShard_) {
+        shard.entries.erase(shard.order.front());
+        shard.order.pop_front();
+        evictions_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+SignatureCache::Stats SignatureCache::getStats() const {
+    Stats stats;
+    stats.hits = hits_.load(std::memory_order_relaxed);
+    stats.misses = misses_.load(std::memory_order_relaxed);
+    stats.insertions = insertions_.load(std::memory_order_relaxed);
+    stats.evictions = evictions_.load(std::memory_order_relaxed);
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        stats.size += shard.entries.size();
+    }
+    return stats;
+}
+
+void SignatureCache::clear() {
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.entries.clear();
+        shard.order.clear();
+    }
+    hits_.store(0, std::memory_order_relaxed);
+    misses_.store(0, std::memory_order_relaxed);
+    insertions_.store(0, std::memory_order_relaxed);
+    evictions_.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,65 @@
+#ifndef SIGNATURE_CACHE_HPP
+#define SIGNATURE_CACHE_HPP
+
+#include "cryptography/crypto.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <unordered_set>
+
+/**
+ * Cache des signatures déjà vérifiées, partagé entre le mempool et la validation des blocs.
+ * Une entrée est l'empreinte de (sighash, clé publique, signature) : une transaction vérifiée
+ * à son arrivée dans le mempool n'est pas revérifiée quand elle apparaît dans un bloc.
+ * Le cache est borné (éviction FIFO) et découpé en shards pour limiter la contention.
+ */
+class SignatureCache {
+public:
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t insertions = 0;
+        uint64_t evictions = 0;
+        size_t size = 0;
+
+        double hitRate() const { return hits + misses > 0 ? static_cast<double>(hits) / (hits + misses) : 0.0; }
+    };
+
+    explicit SignatureCache(size_t maxEntries = 200000);
+
+    /*Cache partagé par tout le noeud*/
+    static SignatureCache& instance();
+
+    /*Retourne true si cette signature a déjà été vérifiée valide (compte un hit ou un miss)*/
+    bool contains(const Hash& sigHash, const PubKey& pubKey, const Signature& signature);
+    /*Enregistre une signature vérifiée valide*/
+    void insert(const Hash& sigHash, const PubKey& pubKey, const Signature& signature);
+
+    Stats getStats() const;
+    void clear();
+
+private:
+    static constexpr size_t kShards = 16;
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::unordered_set<Hash> entries;
+        std::deque<Hash> order; // ordre d'insertion pour l'éviction
+    };
+
+    std::array<Shard, kShards> shards_;
+    const size_t maxPerShard_;
+
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> insertions_{0};
+    std::atomic<uint64_t> evictions_{0};
+
+    static Hash makeKey(const Hash& sigHash, const PubKey& pubKey, const Signature& signature);
+    Shard& shardFor(const Hash& key) { return shards_[key[0] % kShards]; }
+};
+
+#endif // SIGNATURE_CACHE_HPP
@@ -0,0 +1,136 @@
+#include "cryptography/VerificationPool.hpp"
+
+#include <algorithm>
+
+VerificationPool::VerificationPool(unsigned nbWorkers) {
+    // le thread appelant compte comme un worker
+    const size_t nbThreads = nbWorkers > 1 ? nbWorkers - 1 : 0;
+    for (size_t i = 0; i < nbThreads + 1; ++i) {
+        queues_.push_back(std::make_unique<Queue>());
+    }
+    for (size_t i = 0; i < nbThreads; ++i) {
+        threads_.emplace_back([this, i]{ workerLoop(i); });
+    }
+}
+
+VerificationPool::~VerificationPool() {
+    {
+        std::lock_guard<std::mutex> lk(sleepMutex_);
+        stop_ = true;
+    }
+    wakeUp_.notify_all();
+    for (auto& t : threads_) {
+        if (t.joinable()) t.join();
+    }
+}
+
+VerificationPool& VerificationPool::instance() {
+    static VerificationPool pool;
+    return pool;
+}
+
+bool VerificationPool::run(size_t count, const Check& check) {
+    if (count == 0) return true;
+
+    // Pas de worker ou lot trivial : inutile de passer par les files
+    if (threads_.empty() || count == 1) {
+        for (size_t i = 0; i < count; ++i) {
+            if (!check(i)) return false;
+        }
+        return true;
+    }
+
+    Batch batch;
+    batch.check = &check;
+
+    // ~4 tranches par file pour que le vol de travail puisse équilibrer la charge
+    const size_t nbQueues = queues_.size();
+    const size_t grain = std::max<size_t>(1, count / (nbQueues * 4));
+    const size_t nbTasks = (count + grain - 1) / grain;
+    batch.remaining.store(nbTasks, std::memory_order_relaxed);
+    pending_.fetch_add(nbTasks, std::memory_order_release);
+
+    size_t q = 0;
+    for (size_t begin = 0; begin < count; begin += grain) {
+        std::lock_guard<std::mutex> lk(queues_[q]->mutex);
+        queues_[q]->tasks.push_back(Task{&batch, begin, std::min(begin + grain, count)});
+        q = (q + 1) % nbQueues;
+    }
+    {
+        std::lock_guard<std::mutex> lk(sleepMutex_);
+    }
+    wakeUp_.notify_all();
+
+    // Le thread appelant vide sa file puis vole comme les autres
+    const size_t self = nbQueues - 1;
+    Task task;
+    while (batch.remaining.load(std::memory_order_acquire) > 0 && popOrSteal(self, task)) {
+        execute(task);
+    }
+
+    std::unique_lock<std::mutex> lk(sleepMutex_);
+    batchDone_.wait(lk, [&batch]{ return batch.remaining.load(std::memory_order_acquire) == 0; });
+    return !batch.failed.load(std::memory_order_acquire);
+}
+
+void VerificationPool::workerLoop(size_t self) {
+    while (true) {
+        Task task;
+        if (popOrSteal(self, task)) {
+            execute(task);
+            continue;
+        }
+        std::unique_lock<std::mutex> lk(sleepMutex_);
+        wakeUp_.wait(lk, [this]{ return stop_ || pending_.load(std::memory_order_acquire) > 0; });
+        if (stop_) return;
+    }
+}
+
+bool VerificationPool::popOrSteal(size_t self, Task& out) {
+    const size_t nbQueues = queues_.size();
+
+    // Sa propre file par l'avant
+    {
+        Queue& own = *queues_[self];
+        std::lock_guard<std::mutex> lk(own.mutex);
+        if (!own.tasks.empty()) {
+            out = own.tasks.front();
+            own.tasks.pop_front();
+            pending_.fetch_sub(1, std::memory_order_acq_rel);
+            return true;
+        }
+    }
+    // Sinon vole par l'arrière dans les autres files
+    for (size_t k = 1; k < nbQueues; ++k) {
+        Queue& victim = *queues_[(self + k) % nbQueues];
+        std::lock_guard<std::mutex> lk(victim.mutex);
+        if (!victim.tasks.empty()) {
+            out = victim.tasks.back();
+            victim.tasks.pop_back();
+            pending_.fetch_sub(1, std::memory_order_acq_rel);
+            return true;
+        }
+    }
+    return false;
+}
+
+void VerificationPool::execute(const Task& task) {
+    Batch& batch = *task.batch;
+    for (size_t i = task.begin; i < task.end && !batch.failed.load(std::memory_order_relaxed); ++i) {
+        bool ok = false;
+        try {
+            ok = (*batch.check)(i);
+        } catch (...) {
+            ok = false;
+        }
+        if (!ok) {
+            batch.failed.store(true, std::memory_order_release);
+            break;
+        }
+    }
+    // Dernière tranche du lot : réveille l'appelant (le lot peut être détruit juste après)
+    if (batch.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        std::lock_guard<std::mutex> lk(sleepMutex_);
+        batchDone_.notify_all();
+    }
+}
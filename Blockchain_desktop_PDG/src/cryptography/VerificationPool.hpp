@@ -0,0 +1,68 @@
+#ifndef VERIFICATION_POOL_HPP
+#define VERIFICATION_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Pool de threads dédié aux vérifications de signatures.
+ * Un lot de vérifications est découpé en tranches réparties dans une file par worker ;
+ * un worker dont la file est vide vole des tranches dans les files des autres (work-stealing).
+ * Le thread appelant participe au travail et le lot s'arrête à la première vérification qui échoue.
+ */
+class VerificationPool {
+public:
+    using Check = std::function<bool(size_t)>;
+
+    explicit VerificationPool(unsigned nbWorkers = std::thread::hardware_concurrency());
+    ~VerificationPool();
+
+    VerificationPool(const VerificationPool&) = delete;
+    VerificationPool& operator=(const VerificationPool&) = delete;
+
+    /*Pool partagé par tout le noeud (un worker par coeur, le thread appelant compris)*/
+    static VerificationPool& instance();
+
+    /*Exécute check(0..count-1) en parallèle. Retourne false dès qu'un check échoue, les tranches restantes sont abandonnées*/
+    bool run(size_t count, const Check& check);
+
+    size_t workerCount() const { return threads_.size(); }
+
+private:
+    struct Batch {
+        const Check* check;
+        std::atomic<bool> failed{false};
+        std::atomic<size_t> remaining{0}; // tranches pas encore terminées
+    };
+    struct Task {
+        Batch* batch;
+        size_t begin;
+        size_t end;
+    };
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues_; // une file par worker + une pour les appelants
+    std::vector<std::thread> threads_;
+
+    std::mutex sleepMutex_;
+    std::condition_variable wakeUp_;   // nouvelles tranches disponibles
+    std::condition_variable batchDone_; // un lot vient de se terminer
+    std::atomic<size_t> pending_{0};    // tranches en attente dans les files
+    bool stop_{false};
+
+    void workerLoop(size_t self);
+    bool popOrSteal(size_t self, Task& out);
+    void execute(const Task& task);
+};
+
+#endif // VERIFICATION_POOL_HPP
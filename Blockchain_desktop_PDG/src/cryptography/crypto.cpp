@@ -1,11 +1,79 @@
 #include "cryptography/crypto.hpp"
+#include "cryptography/PubKeyCache.hpp"
+#include "cryptography/CryptoContext.hpp"
+#include "cryptography/Sha256.hpp"
 
+#include <cstring>
 #include <fstream>
 #include <sstream>
-#include <algorithm>
+
+#include <openssl/bn.h>
+#include <openssl/ec.h>
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+#include <openssl/core_names.h>
+#include <openssl/params.h>
+#endif
 
 namespace crypto {
 
+    namespace {
+        // Moitié de l'ordre n de secp256k1 : (r, s) et (r, n - s) sont deux signatures valides du même message,
+        // seule la forme s <= n/2 est acceptée pour que le txid (qui couvre la signature) ne soit pas malléable
+        const BIGNUM* halfOrder() {
+            static const BIGNUM* half = [] {
+                BIGNUM* bn = nullptr;
+                BN_hex2bn(&bn, "7FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF5D576E7357A4501DDFE92F46681B20A0");
+                return bn;
+            }();
+            return half;
+        }
+        const BIGNUM* curveOrder() {
+            static const BIGNUM* order = [] {
+                BIGNUM* bn = nullptr;
+                BN_hex2bn(&bn, "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD0364141");
+                return bn;
+            }();
+            return order;
+        }
+
+        ECDSA_SIG* decodeSignature(std::span<const uint8_t> signature) {
+            const unsigned char* p = signature.data();
+            return d2i_ECDSA_SIG(nullptr, &p, static_cast<long>(signature.size()));
+        }
+
+        bool isLowS(std::span<const uint8_t> signature) {
+            ECDSA_SIG* sig = decodeSignature(signature);
+            if (!sig) {
+                return false;
+            }
+            const bool low = BN_cmp(ECDSA_SIG_get0_s(sig), halfOrder()) <= 0;
+            ECDSA_SIG_free(sig);
+            return low;
+        }
+
+        /*Remplace s par n - s si s > n/2 (signature DER réécrite dans out) et retourne la nouvelle taille*/
+        size_t normalizeLowS(std::span<uint8_t> out, size_t signatureLen) {
+            ECDSA_SIG* sig = decodeSignature(out.first(signatureLen));
+            if (!sig) {
+                throw std::runtime_error("Failed to decode signature");
+            }
+            if (BN_cmp(ECDSA_SIG_get0_s(sig), halfOrder()) > 0) {
+                BIGNUM* r = BN_dup(ECDSA_SIG_get0_r(sig));
+                BIGNUM* s = BN_new();
+                if (!r || !s || BN_sub(s, curveOrder(), ECDSA_SIG_get0_s(sig)) != 1 || ECDSA_SIG_set0(sig, r, s) != 1) {
+                    BN_free(r);
+                    BN_free(s);
+                    ECDSA_SIG_free(sig);
+                    throw std::runtime_error("Failed to normalize signature");
+                }
+                unsigned char* p = out.data();
+                signatureLen = static_cast<size_t>(i2d_ECDSA_SIG(sig, &p));
+            }
+            ECDSA_SIG_free(sig);
+            return signatureLen;
+        }
+    }
+
 
     EVP_PKEY* createPrivateKey() {
 
@@ -71,48 +139,29 @@ namespace crypto {
         if (!pkey) {
             throw std::runtime_error("Invalid private key");
         }
-        // Create signature context
-        EVP_MD_CTX* ctx = EVP_MD_CTX_new();
-        if (!ctx) {
-            throw std::runtime_error("Failed to create EVP_MD_CTX");
-        }
-        // Initialize signing context
-        if (EVP_DigestSignInit(ctx, NULL, EVP_sha256(), NULL, pkey) != 1) {
-            EVP_MD_CTX_free(ctx);
-            throw std::runtime_error("Failed to initialize signing context");
+        Signature signature(EVP_PKEY_size(pkey), '\0');
+        const size_t signatureLen = signData(asBytes(data), pkey,
+            std::span<uint8_t>(reinterpret_cast<uint8_t*>(signature.data()), signature.size()));
+        signature.resize(signatureLen);
+        return signature;
+    }
+
+    size_t signData(std::span<const uint8_t> data, EVP_PKEY* pkey, std::span<uint8_t> out) {
+        if (!pkey) {
+            throw std::runtime_error("Invalid private key");
         }
-        // Add data to sign
-        if (EVP_DigestSignUpdate(ctx, data.c_str(), data.size()) != 1) {
-            EVP_MD_CTX_free(ctx);
-            throw std::runtime_error("Failed to add data to sign");
+        if (out.size() < static_cast<size_t>(EVP_PKEY_size(pkey))) {
+            throw std::runtime_error("Signature buffer too small");
         }
-        // Get required buffer size
-        size_t signatureLen;
-        if (EVP_DigestSignFinal(ctx, NULL, &signatureLen) != 1) {
-            EVP_MD_CTX_free(ctx);
-            EVP_PKEY_free(pkey);
-            throw std::runtime_error("Failed to get required buffer size");
+        EVP_MD_CTX* ctx = CryptoContext::local().sign();
+        if (EVP_DigestSignInit(ctx, NULL, CryptoContext::sha256(), NULL, pkey) != 1) {
+            throw std::runtime_error("Failed to initialize signing context");
         }
-
-        // Create buffer for signature
-        std::vector<unsigned char> signature(signatureLen);
-
-        // Generate signature
-        if (EVP_DigestSignFinal(ctx, signature.data(), &signatureLen) != 1) {
-            EVP_MD_CTX_free(ctx);
-            EVP_PKEY_free(pkey);
+        size_t signatureLen = out.size();
+        if (EVP_DigestSign(ctx, out.data(), &signatureLen, data.data(), data.size()) != 1) {
             throw std::runtime_error("Failed to generate signature");
         }
-
-        // Cleanup
-        EVP_MD_CTX_free(ctx);
-
-        // Resize vector to actual size of signature
-        signature.resize(signatureLen);
-
-        std::string signatureStr(signature.begin(), signature.end());
-
-        return signatureStr;
+        return normalizeLowS(out, signatureLen);
     }
 
     const PubKey getPubKey(const EVP_PKEY* pkey) {
@@ -120,90 +169,104 @@ namespace crypto {
             throw std::runtime_error("Invalid EVP_PKEY");
         }
 
-        // Get public key from private key
-        BIO* bio = BIO_new(BIO_s_mem());
-        if (!bio) {
-            throw std::runtime_error("Failed to create BIO");
+        // Point public encodé (non compressé par défaut : 0x04 || X || Y)
+        unsigned char* encoded = nullptr;
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+        const size_t encodedLen = EVP_PKEY_get1_encoded_public_key(const_cast<EVP_PKEY*>(pkey), &encoded);
+#else
+        const size_t encodedLen = EVP_PKEY_get1_tls_encodedpoint(const_cast<EVP_PKEY*>(pkey), &encoded);
+#endif
+        if (encodedLen == 0 || !encoded) {
+            throw std::runtime_error("Failed to encode public key");
         }
 
-        if (PEM_write_bio_PUBKEY(bio, pkey) != 1) {
-            BIO_free(bio);
-            throw std::runtime_error("Failed to write public key");
-        }
-
-        // Read public key from BIO
-        char* pubKey;
-        size_t pubKeyLen = BIO_get_mem_data(bio, &pubKey);
-        std::string pubKeyStr(pubKey, pubKeyLen);
-
-        // Remove PEM headers and footers
-        std::string beginMarker = "-----BEGIN PUBLIC KEY-----";
-        std::string endMarker = "-----END PUBLIC KEY-----";
-        
-        size_t start = pubKeyStr.find(beginMarker);
-        if (start != std::string::npos) {
-            start += beginMarker.length();
-            size_t end = pubKeyStr.find(endMarker);
-            if (end != std::string::npos) {
-                pubKeyStr = pubKeyStr.substr(start, end - start);
-                // Remove newlines and whitespace
-                pubKeyStr.erase(std::remove_if(pubKeyStr.begin(), pubKeyStr.end(), 
-                    [](char c) { return std::isspace(c); }), pubKeyStr.end());
-            }
+        PubKey pubKey;
+        if (encodedLen == 1 + 2 * 32 && encoded[0] == 0x04) {
+            // Compression : préfixe 0x02/0x03 selon la parité de Y, puis X
+            pubKey[0] = static_cast<uint8_t>(0x02 | (encoded[encodedLen - 1] & 1));
+            std::memcpy(pubKey.data() + 1, encoded + 1, 32);
+        } else if (encodedLen == PubKey::SIZE && (encoded[0] == 0x02 || encoded[0] == 0x03)) {
+            std::memcpy(pubKey.data(), encoded, PubKey::SIZE);
+        } else {
+            OPENSSL_free(encoded);
+            throw std::runtime_error("Unexpected public key encoding (secp256k1 expected)");
         }
-
-        // Cleanup
-        BIO_free(bio);
-
-        return pubKeyStr;
+        OPENSSL_free(encoded);
+        return pubKey;
     }
 
-    bool verifySignature(const std::string& data, const Signature& signature, const PubKey& pubKey) {
-
-        std::string keyPem = "-----BEGIN PUBLIC KEY-----\n" + pubKey + "\n-----END PUBLIC KEY-----";
-
-        // Load public key
-        BIO* bio = BIO_new_mem_buf(keyPem.data(), keyPem.size());
-        EVP_PKEY* pkey = PEM_read_bio_PUBKEY(bio, NULL, NULL, NULL);
-        BIO_free(bio);
-        if (!pkey) {
-            return false;
+    PubKeyHandle decodePubKey(const PubKey& pubKey) {
+        if (pubKey[0] != 0x02 && pubKey[0] != 0x03) {
+            return nullptr;
         }
-
-        // Create verification context
-        EVP_MD_CTX* ctx = EVP_MD_CTX_new();
+        EVP_PKEY* pkey = nullptr;
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+        // Construit la clé directement depuis le point compressé (OpenSSL vérifie qu'il est sur la courbe)
+        OSSL_PARAM params[] = {
+            OSSL_PARAM_construct_utf8_string(OSSL_PKEY_PARAM_GROUP_NAME, const_cast<char*>("secp256k1"), 0),
+            OSSL_PARAM_construct_octet_string(OSSL_PKEY_PARAM_PUB_KEY, const_cast<uint8_t*>(pubKey.data()), PubKey::SIZE),
+            OSSL_PARAM_construct_end()
+        };
+        EVP_PKEY_CTX* ctx = EVP_PKEY_CTX_new_from_name(NULL, "EC", NULL);
         if (!ctx) {
-            EVP_PKEY_free(pkey);
-            return false;
+            return nullptr;
         }
-
-        // Initialize verification context
-        if (EVP_DigestVerifyInit(ctx, NULL, EVP_sha256(), NULL, pkey) != 1) {
-            EVP_MD_CTX_free(ctx);
-            EVP_PKEY_free(pkey);
-            return false;
+        if (EVP_PKEY_fromdata_init(ctx) != 1 || EVP_PKEY_fromdata(ctx, &pkey, EVP_PKEY_PUBLIC_KEY, params) != 1) {
+            pkey = nullptr;
         }
-
-        if (EVP_DigestVerifyUpdate(ctx, data.c_str(), data.size()) != 1) {
-            EVP_MD_CTX_free(ctx);
+        EVP_PKEY_CTX_free(ctx);
+#else
+        EC_KEY* ecKey = EC_KEY_new_by_curve_name(NID_secp256k1);
+        const unsigned char* point = pubKey.data();
+        if (!ecKey || !o2i_ECPublicKey(&ecKey, &point, PubKey::SIZE)) {
+            EC_KEY_free(ecKey);
+            return nullptr;
+        }
+        pkey = EVP_PKEY_new();
+        if (!pkey || EVP_PKEY_assign_EC_KEY(pkey, ecKey) != 1) {
             EVP_PKEY_free(pkey);
-            return false;
+            EC_KEY_free(ecKey);
+            return nullptr;
+        }
+#endif
+        if (!pkey) {
+            return nullptr;
         }
+        return PubKeyHandle(pkey, EVP_PKEY_free);
+    }
 
-        // Verify signature
-        bool isValid = EVP_DigestVerifyFinal(ctx, reinterpret_cast<const unsigned char*>(signature.data()), signature.size()) == 1;
+    bool verifySignature(const std::string& data, const Signature& signature, const PubKey& pubKey) {
+        return verifySignature(data, signature, PubKeyCache::instance().get(pubKey));
+    }
 
-        // Cleanup
-        EVP_MD_CTX_free(ctx);
-        EVP_PKEY_free(pkey);
+    bool verifySignature(const std::string& data, const Signature& signature, const PubKeyHandle& pubKey) {
+        return verifySignature(asBytes(data), asBytes(signature), pubKey);
+    }
 
-        return isValid;
+    bool verifySignature(std::span<const uint8_t> data, std::span<const uint8_t> signature, const PubKey& pubKey) {
+        return verifySignature(data, signature, PubKeyCache::instance().get(pubKey));
+    }
+
+    bool verifySignature(std::span<const uint8_t> data, std::span<const uint8_t> signature, const PubKeyHandle& pubKey) {
+        if (!pubKey || !isLowS(signature)) {
+            return false;
+        }
+        EVP_MD_CTX* ctx = CryptoContext::local().verify();
+        if (EVP_DigestVerifyInit(ctx, NULL, CryptoContext::sha256(), NULL, pubKey.get()) != 1) {
+            return false;
+        }
+        return EVP_DigestVerify(ctx, signature.data(), signature.size(), data.data(), data.size()) == 1;
     }
 
     Hash hashData(const std::string& data) {
-        unsigned char hash[SHA256_DIGEST_LENGTH];
-        SHA256(reinterpret_cast<const unsigned char*>(data.c_str()), data.size(), hash);
-        return Hash(hash, hash + SHA256_DIGEST_LENGTH);
+        Hash hash;
+        hashData(asBytes(data), hash.bytes);
+        return hash;
+    }
+
+    void hashData(std::span<const uint8_t> data, std::span<uint8_t, HASH_SIZE> out) {
+        // SHA-256 interne (SHA-NI / portable selon le CPU), sans passer par OpenSSL
+        sha256::hash(data, out);
     }
 
-}
\ No newline at end of file
+}
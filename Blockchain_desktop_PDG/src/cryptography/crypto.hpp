@@ -4,9 +4,9 @@
 #include <string>
 #include <vector>
 
-using PubKey = std::string;
+#include "cryptography/FixedBytes.hpp"
+
 using Signature = std::string;
-using Hash = std::string;
 
 
 #include <stdexcept>
@@ -18,6 +18,9 @@ using Hash = std::string;
 #include <openssl/sha.h>
 #include <openssl/rand.h>
 #include <iomanip>
+#include <memory>
+#include <span>
+#include <cstdint>
 #include <string>
 
 
@@ -25,13 +28,40 @@ namespace crypto{
 
     EVP_PKEY* createPrivateKey();
     EVP_PKEY* getPrivateKey(const std::string& privateKeyFile);
+    /*Clé publique compressée (33 octets) de la paire de clés*/
     const PubKey getPubKey(const EVP_PKEY* pkey);
     void savePrivateKey(EVP_PKEY* pkey, const std::string& filename);
     
+    /*Clé publique déjà décodée, partageable entre threads (lecture seule)*/
+    using PubKeyHandle = std::shared_ptr<EVP_PKEY>;
+
     Signature signData(const std::string& transaction, EVP_PKEY* pkey);
+    /*Vérifie une signature ; la clé décodée est prise dans le PubKeyCache*/
     bool verifySignature(const std::string& data, const Signature& signature, const PubKey& pubKey);
+    /*Vérifie une signature avec une clé déjà décodée*/
+    bool verifySignature(const std::string& data, const Signature& signature, const PubKeyHandle& pubKey);
+
+    /*Construit la clé depuis le point compressé (33 octets). Retourne nullptr si le point est invalide*/
+    PubKeyHandle decodePubKey(const PubKey& pubKey);
 
     Hash hashData(const std::string& data);
 
+    // Variantes sans allocation : contextes OpenSSL réutilisés par thread (CryptoContext),
+    // résultat écrit dans un buffer fourni par l'appelant
+    constexpr size_t HASH_SIZE = Hash::SIZE;
+    constexpr size_t MAX_SIGNATURE_SIZE = 72; // ECDSA secp256k1 encodée en DER
+
+    inline std::span<const uint8_t> asBytes(const std::string& str) {
+        return {reinterpret_cast<const uint8_t*>(str.data()), str.size()};
+    }
+
+    /*Calcule le SHA-256 de data dans out (implémentation interne, voir Sha256.hpp)*/
+    void hashData(std::span<const uint8_t> data, std::span<uint8_t, HASH_SIZE> out);
+    /*Signe data dans out (au moins EVP_PKEY_size(pkey) octets) et retourne la taille de la signature, toujours de forme s <= n/2*/
+    size_t signData(std::span<const uint8_t> data, EVP_PKEY* pkey, std::span<uint8_t> out);
+    /*Refuse une signature de forme s > n/2 (malléable : même message, autre txid)*/
+    bool verifySignature(std::span<const uint8_t> data, std::span<const uint8_t> signature, const PubKeyHandle& pubKey);
+    bool verifySignature(std::span<const uint8_t> data, std::span<const uint8_t> signature, const PubKey& pubKey);
+
 }
 #endif // CRYPTO_HPP
@@ -5,6 +5,10 @@
 #include <QDir>
 #include <QDebug>
 #include <QFileInfo>
+#include <QTimer>
+
+#include <chrono>
+#include <future>
 
 #include "Blockchain.hpp"
 #include "ui/BlockchainFacade.hpp"
@@ -66,6 +70,22 @@ int main(int argc, char *argv[])
 
     static Blockchain blockchain;
 
+    // Transactions en attente de la session précédente (revalidées quand la chaîne a rattrapé la hauteur de sauvegarde)
+    const std::string mempoolPath = (configPath + "/mempool.dat").toStdString();
+    if (blockchain.loadMempool(mempoolPath)) {
+        qInfo() << "Sauvegarde de la pool relue:" << QString::fromStdString(mempoolPath);
+    }
+    // Sauvegarde périodique hors du thread de l'interface ; sautée si la précédente n'est pas terminée
+    std::future<bool> mempoolSave;
+    QTimer mempoolTimer;
+    QObject::connect(&mempoolTimer, &QTimer::timeout, [&]() {
+        if (mempoolSave.valid() && mempoolSave.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            return;
+        }
+        mempoolSave = std::async(std::launch::async, [&]() { return blockchain.saveMempool(mempoolPath); });
+    });
+    mempoolTimer.start(MEMPOOL_SAVE_INTERVAL_S * 1000);
+
     static BlockchainFacade blockchainFacade(blockchain, privKey);
 
     QQmlApplicationEngine engine;
@@ -85,6 +105,13 @@ int main(int argc, char *argv[])
     QObject::connect(&app, &QGuiApplication::aboutToQuit, [&]() {
         blockchain.stopMining();
         blockchain.getNetwork().stop();
+        mempoolTimer.stop();
+        if (mempoolSave.valid()) {
+            mempoolSave.wait(); // même fichier temporaire : la sauvegarde finale passe après
+        }
+        if (!blockchain.saveMempool(mempoolPath)) {
+            qWarning() << "Impossible de sauvegarder la pool de transactions:" << QString::fromStdString(mempoolPath);
+        }
         if (privKey) {
             EVP_PKEY_free(privKey);
         }
@@ -0,0 +1,183 @@
+#include "network/AdmissionQueue.hpp"
+#include "cryptography/VerificationPool.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+AdmissionQueue::AdmissionQueue(Prepare prepare, Admit admit, OnAccepted onAccepted, std::shared_mutex* chainLock)
+    : prepare_(std::move(prepare)), admit_(std::move(admit)), onAccepted_(std::move(onAccepted)), chainLock_(chainLock) {
+    worker_ = std::thread([this]{ workerLoop(); });
+}
+
+AdmissionQueue::~AdmissionQueue() {
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        stop_ = true;
+    }
+    wakeUp_.notify_all();
+    if (worker_.joinable()) worker_.join();
+}
+
+bool AdmissionQueue::enqueue(Transaction tx, const PeerInfo& from) {
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        if (items_.size() >= kMaxDepth) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        items_.push_back(Item{std::move(tx), from, std::chrono::steady_clock::now()});
+        maxDepth_ = std::max(maxDepth_, items_.size());
+    }
+    enqueued_.fetch_add(1, std::memory_order_relaxed);
+    wakeUp_.notify_one();
+    return true;
+}
+
+void AdmissionQueue::post(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        tasks_.push_back(std::move(task));
+    }
+    wakeUp_.notify_one();
+}
+
+void AdmissionQueue::drain() {
+    std::unique_lock<std::mutex> lk(mutex_);
+    idle_.wait(lk, [this]{ return items_.empty() && tasks_.empty() && inFlight_ == 0; });
+}
+
+void AdmissionQueue::releaseOrphans(const Transaction& parent) {
+    for (auto& orphan : orphans_.takeChildren(parent)) {
+        enqueue(std::move(orphan.tx), orphan.from);
+    }
+}
+
+AdmissionQueue::Stats AdmissionQueue::getStats() const {
+    Stats s;
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        s.depth = items_.size() + inFlight_;
+        s.maxDepth = maxDepth_;
+    }
+    s.enqueued = enqueued_.load(std::memory_order_relaxed);
+    s.accepted = accepted_.load(std::memory_order_relaxed);
+    s.rejected = rejected_.load(std::memory_order_relaxed);
+    s.dropped = dropped_.load(std::memory_order_relaxed);
+    s.orphaned = orphaned_.load(std::memory_order_relaxed);
+    s.orphansAccepted = orphansAccepted_.load(std::memory_order_relaxed);
+    s.orphans = orphans_.getStats();
+    s.batches = batches_.load(std::memory_order_relaxed);
+    s.lastBatchSize = lastBatchSize_.load(std::memory_order_relaxed);
+    const uint64_t decided = s.accepted + s.rejected + s.orphaned;
+    s.avgLatencyUs = decided > 0 ? static_cast<double>(totalLatencyUs_.load(std::memory_order_relaxed)) / decided : 0.0;
+    s.maxLatencyUs = static_cast<double>(maxLatencyUs_.load(std::memory_order_relaxed));
+    return s;
+}
+
+void AdmissionQueue::workerLoop() {
+    std::vector<Item> batch;
+    batch.reserve(kMaxBatch);
+    std::vector<std::function<void()>> tasks;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lk(mutex_);
+            wakeUp_.wait(lk, [this]{ return stop_ || !items_.empty() || !tasks_.empty(); });
+            if (stop_) return;
+            tasks.swap(tasks_);
+            // Tout ce qui est arrivé pendant le lot précédent part dans le suivant (dans la limite de kMaxBatch)
+            const size_t n = std::min(items_.size(), kMaxBatch);
+            for (size_t i = 0; i < n; ++i) {
+                batch.push_back(std::move(items_.front()));
+                items_.pop_front();
+            }
+            inFlight_ = n + tasks.size();
+        }
+
+        {
+            std::shared_lock<std::shared_mutex> chain;
+            if (chainLock_) chain = std::shared_lock<std::shared_mutex>(*chainLock_);
+            for (auto& task : tasks) {
+                try { task(); } catch (...) {}
+            }
+            if (!batch.empty()) process(batch);
+        }
+        batch.clear();
+        tasks.clear();
+
+        {
+            std::lock_guard<std::mutex> lk(mutex_);
+            inFlight_ = 0;
+            if (items_.empty() && tasks_.empty()) idle_.notify_all();
+        }
+    }
+}
+
+void AdmissionQueue::process(std::vector<Item>& batch) {
+    // Signatures : indépendantes entre elles, un échec ne doit pas interrompre le reste du lot
+    std::vector<uint8_t> prepared(batch.size(), 0);
+    VerificationPool::instance().run(batch.size(), [this, &batch, &prepared](size_t i) {
+        try {
+            prepared[i] = prepare_(batch[i].tx) ? 1 : 0;
+        } catch (...) {
+            prepared[i] = 0;
+        }
+        return true;
+    });
+
+    // Admission séquentielle : l'ordre d'arrivée départage deux transactions qui dépensent la même sortie
+    for (size_t i = 0; i < batch.size(); ++i) {
+        Verdict verdict = Verdict::Rejected;
+        if (prepared[i]) {
+            try {
+                verdict = admit_(batch[i].tx);
+            } catch (...) {
+                verdict = Verdict::Rejected;
+            }
+        }
+        const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - batch[i].enqueuedAt).count();
+        totalLatencyUs_.fetch_add(static_cast<uint64_t>(latency), std::memory_order_relaxed);
+        uint64_t previousMax = maxLatencyUs_.load(std::memory_order_relaxed);
+        while (static_cast<uint64_t>(latency) > previousMax
+               && !maxLatencyUs_.compare_exchange_weak(previousMax, static_cast<uint64_t>(latency), std::memory_order_relaxed)) {}
+
+        if (verdict == Verdict::Accepted) {
+            accepted_.fetch_add(1, std::memory_order_relaxed);
+            if (onAccepted_) {
+                try { onAccepted_(batch[i].tx, batch[i].from); } catch (...) {}
+            }
+            admitOrphans(batch[i].tx);
+        } else if (verdict == Verdict::MissingParents && orphans_.add(batch[i].tx, batch[i].from)) {
+            orphaned_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            rejected_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    batches_.fetch_add(1, std::memory_order_relaxed);
+    lastBatchSize_.store(batch.size(), std::memory_order_relaxed);
+}
+
+void AdmissionQueue::admitOrphans(const Transaction& parent) {
+    std::vector<OrphanPool::Orphan> ready = orphans_.takeChildren(parent);
+    while (!ready.empty()) {
+        OrphanPool::Orphan orphan = std::move(ready.back());
+        ready.pop_back();
+        // Signature vérifiée par admit : le parent manquait lors de prepare
+        Verdict verdict = Verdict::Rejected;
+        try {
+            verdict = admit_(orphan.tx);
+        } catch (...) {
+            verdict = Verdict::Rejected;
+        }
+        if (verdict == Verdict::Accepted) {
+            orphansAccepted_.fetch_add(1, std::memory_order_relaxed);
+            if (onAccepted_) {
+                try { onAccepted_(orphan.tx, orphan.from); } catch (...) {}
+            }
+            auto grandChildren = orphans_.takeChildren(orphan.tx);
+            std::move(grandChildren.begin(), grandChildren.end(), std::back_inserter(ready));
+        } else if (verdict == Verdict::MissingParents) {
+            orphans_.add(orphan.tx, orphan.from); // un autre parent manque encore
+        }
+    }
+}
@@ -0,0 +1,118 @@
+#ifndef ADMISSION_QUEUE_HPP
+#define ADMISSION_QUEUE_HPP
+
+#include "transaction/Transaction.hpp"
+#include "network/PeerInfo.hpp"
+#include "network/OrphanPool.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * File d'admission des transactions reçues du réseau (plusieurs producteurs, un consommateur).
+ * Le thread réseau ne fait que déposer la transaction désérialisée ; un thread dédié vide la
+ * file par lots : signatures vérifiées en parallèle sur le VerificationPool (prepare, qui
+ * remplit le SignatureCache), puis admission séquentielle (admit) et relais des acceptées.
+ * Une transaction dont un parent manque attend dans l'OrphanPool et repasse par admit dès
+ * que ce parent est accepté.
+ * Le verrou de la chaîne est tenu en lecture pendant tout un lot : un bloc ne peut pas être
+ * connecté entre la vérification d'une transaction et son admission. D'autres tâches qui
+ * admettent dans la pool (relecture de la sauvegarde) passent par le même thread avec post.
+ */
+class AdmissionQueue {
+public:
+    enum class Verdict { Accepted, Rejected, MissingParents };
+
+    using Prepare = std::function<bool(const Transaction&)>;                    // sans état partagé, appelé en parallèle
+    using Admit = std::function<Verdict(const Transaction&)>;                   // appelé dans l'ordre d'arrivée
+    using OnAccepted = std::function<void(const Transaction&, const PeerInfo&)>;
+
+    struct Stats {
+        uint64_t enqueued = 0;
+        uint64_t accepted = 0;
+        uint64_t rejected = 0;
+        uint64_t dropped = 0;         // file pleine
+        uint64_t orphaned = 0;        // mises en attente d'un parent
+        uint64_t orphansAccepted = 0; // acceptées à l'arrivée de leur parent
+        size_t depth = 0;             // en attente
+        size_t maxDepth = 0;
+        size_t lastBatchSize = 0;
+        uint64_t batches = 0;
+        double avgLatencyUs = 0.0;    // dépôt -> décision
+        double maxLatencyUs = 0.0;
+        OrphanPool::Stats orphans;
+
+        double avgBatchSize() const { return batches > 0 ? static_cast<double>(accepted + rejected + orphaned) / batches : 0.0; }
+    };
+
+    static constexpr size_t kMaxBatch = 256;
+    static constexpr size_t kMaxDepth = 50000;
+
+    AdmissionQueue(Prepare prepare, Admit admit, OnAccepted onAccepted, std::shared_mutex* chainLock = nullptr);
+    ~AdmissionQueue();
+
+    AdmissionQueue(const AdmissionQueue&) = delete;
+    AdmissionQueue& operator=(const AdmissionQueue&) = delete;
+
+    /*Dépose une transaction (ne bloque pas sur la vérification). Retourne false si la file est pleine*/
+    bool enqueue(Transaction tx, const PeerInfo& from);
+    /*Exécute task sur le thread d'admission, verrou de la chaîne en lecture, avant le prochain lot*/
+    void post(std::function<void()> task);
+    /*Attend que toutes les transactions et tâches déposées aient été traitées*/
+    void drain();
+    /*parent accepté hors de la file (transaction locale, bloc) : ses enfants orphelins repassent par la file*/
+    void releaseOrphans(const Transaction& parent);
+
+    Stats getStats() const;
+
+private:
+    struct Item {
+        Transaction tx;
+        PeerInfo from;
+        std::chrono::steady_clock::time_point enqueuedAt;
+    };
+
+    const Prepare prepare_;
+    const Admit admit_;
+    const OnAccepted onAccepted_;
+    std::shared_mutex* const chainLock_; // pris en écriture par Blockchain::addBlock (jamais par les tâches du VerificationPool)
+
+    mutable std::mutex mutex_;
+    std::condition_variable wakeUp_;
+    std::condition_variable idle_;
+    std::deque<Item> items_;
+    std::vector<std::function<void()>> tasks_;
+    size_t inFlight_ = 0; // lot (et tâches) en cours de traitement
+    size_t maxDepth_ = 0;
+    bool stop_ = false;
+
+    std::atomic<uint64_t> enqueued_{0};
+    std::atomic<uint64_t> accepted_{0};
+    std::atomic<uint64_t> rejected_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> orphaned_{0};
+    std::atomic<uint64_t> orphansAccepted_{0};
+    std::atomic<uint64_t> batches_{0};
+    std::atomic<size_t> lastBatchSize_{0};
+    std::atomic<uint64_t> totalLatencyUs_{0};
+    std::atomic<uint64_t> maxLatencyUs_{0};
+
+    OrphanPool orphans_;
+
+    std::thread worker_;
+
+    void workerLoop();
+    void process(std::vector<Item>& batch);
+    /*Réévalue aussitôt les orphelines qui attendaient parent, puis leurs propres enfants*/
+    void admitOrphans(const Transaction& parent);
+};
+
+#endif // ADMISSION_QUEUE_HPP
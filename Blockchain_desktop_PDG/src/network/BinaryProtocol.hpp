@@ -6,10 +6,18 @@
 #include <cstring>
 #include <stdexcept>
 #include <type_traits>
-#include <sstream>
-#include <cereal/archives/binary.hpp>
+#include <span>
 #include <cereal/types/vector.hpp>
 
+#include "network/ByteArchive.hpp"
+#include "network/CompactArchive.hpp"
+
+/*Versions du format des payloads : 2 = montants int64 (Output versionné), clés compressées, sighash binaire,
+3 = même contenu avec entiers varint et inputs delta-encodés (CompactArchive). La version d'une frame est celle de son payload*/
+constexpr uint8_t MIN_PROTOCOL_VERSION = 2;
+constexpr uint8_t COMPACT_PROTOCOL_VERSION = 3;
+constexpr uint8_t PROTOCOL_VERSION = 3;
+
 /*Une frame contient une entete (MsgHeader) et un payload*/
 using Frame = std::vector<uint8_t>;
 
@@ -18,7 +26,7 @@ using Frame = std::vector<uint8_t>;
 #pragma pack(push,1)
 struct MsgHeader {
     uint16_t magic = 0xB17E;    // identifiant protocole (unifié)
-    uint8_t  version = 1;       // version protocole
+    uint8_t  version = PROTOCOL_VERSION; // version protocole
     uint8_t  type = 0;          // code message
     uint32_t length = 0;        // taille payload
     uint32_t checksum = 0;      // checksum pour vérifier l'intégrité
@@ -37,6 +45,7 @@ enum class MsgType : uint8_t {
     TXS = 6,
     BROADCAST_TX = 7,
     BROADCAST_BLOCK = 8,
+    NEGOTIATE = 9,      // payload : version max supportée (1 octet), ignoré par les noeuds v2
 };
 
 
@@ -55,8 +64,9 @@ namespace BinaryProtocol {
 
 
     // Encapsulation d'un message complet en binaire (header + payload)
-    inline Frame buildFrame(MsgType type, uint32_t localSize, const std::vector<uint8_t>& payload){
+    inline Frame buildFrame(MsgType type, uint32_t localSize, std::span<const uint8_t> payload, uint8_t version = PROTOCOL_VERSION){
         MsgHeader h; 
+        h.version = version;
         h.type = static_cast<uint8_t>(type); 
         h.length = static_cast<uint32_t>(payload.size());
         h.checksum = simpleChecksum(payload.data(), payload.size());
@@ -78,7 +88,7 @@ namespace BinaryProtocol {
         if (outHeader.magic != 0xB17E)
             throw std::runtime_error("Bad magic");
 
-        if (outHeader.version != 1)
+        if (outHeader.version < MIN_PROTOCOL_VERSION || outHeader.version > PROTOCOL_VERSION)
             throw std::runtime_error("Bad version");
 
         if (frame.size() != sizeof(MsgHeader) + outHeader.length)
@@ -90,27 +100,44 @@ namespace BinaryProtocol {
             throw std::runtime_error("Bad checksum");
     }
 
-    // Sérialisation d'objets avec Cereal
-    template<typename T, typename Archive = cereal::BinaryOutputArchive>
+    // Sérialisation d'objets avec Cereal, ajoutée à la fin de out (format identique à BinaryOutputArchive)
+    template<typename T, typename Archive = cereal::ByteOutputArchive>
+    void serializeInto(const T& obj, std::vector<uint8_t>& out){
+        Archive ar(out);
+        ar(obj);
+    }
+
+    template<typename T, typename Archive = cereal::ByteOutputArchive>
     std::vector<uint8_t> serializeObject(const T& obj){
-        std::ostringstream oss(std::ios::binary);
-        {
-            Archive ar(oss);
-            ar(obj);
-        }
-        auto str = oss.str();
-        return std::vector<uint8_t>(str.begin(), str.end());
+        std::vector<uint8_t> payload;
+        serializeInto<T, Archive>(obj, payload);
+        return payload;
     }
 
-    // Désérialisation d'objets avec Cereal
-    template<typename T, typename Archive = cereal::BinaryInputArchive>
+    // Désérialisation d'objets avec Cereal, lue directement dans le payload (aucune copie)
+    template<typename T, typename Archive = cereal::SpanInputArchive>
     T deserializeObject(const uint8_t* data, size_t len){
-        std::istringstream iss(std::string(reinterpret_cast<const char*>(data), len), std::ios::binary);
-        Archive ar(iss);
+        Archive ar(std::span<const uint8_t>(data, len));
         T obj;
         ar(obj);
         return obj;
     }
+
+    // Variantes selon la version négociée avec le pair (v2 : entiers à taille fixe, v3 : compact)
+    template<typename T>
+    void serializeInto(const T& obj, std::vector<uint8_t>& out, uint8_t version){
+        if (version >= COMPACT_PROTOCOL_VERSION)
+            serializeInto<T, cereal::CompactOutputArchive>(obj, out);
+        else
+            serializeInto<T, cereal::ByteOutputArchive>(obj, out);
+    }
+
+    template<typename T>
+    T deserializeObject(const uint8_t* data, size_t len, uint8_t version){
+        if (version >= COMPACT_PROTOCOL_VERSION)
+            return deserializeObject<T, cereal::CompactInputArchive>(data, len);
+        return deserializeObject<T, cereal::SpanInputArchive>(data, len);
+    }
 }
 
 #endif // BINARY_PROTOCOL_HPP
@@ -0,0 +1,82 @@
+#ifndef BULK_ENCODING_HPP
+#define BULK_ENCODING_HPP
+
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include <cereal/cereal.hpp>
+#include <cereal/archives/binary.hpp>
+
+#include "network/ByteArchive.hpp"
+
+/**
+ * Encodage en bloc des enregistrements de taille fixe (OutputReference, Target...).
+ * Sur les archives binaires brutes, un enregistrement sans padding dont les champs sont
+ * déclarés dans l'ordre de sérialisation s'écrit avec un seul memcpy, et un vecteur de
+ * ces enregistrements aussi. Les octets produits sont identiques à la sérialisation
+ * champ par champ ; les autres archives (et types) gardent le chemin habituel de cereal.
+ */
+namespace bulk {
+
+    /*Archives qui écrivent les octets tels quels (ordre natif, sans métadonnées)*/
+    template<class Archive>
+    inline constexpr bool isRawArchive =
+        std::is_same_v<Archive, cereal::BinaryOutputArchive> || std::is_same_v<Archive, cereal::BinaryInputArchive> ||
+        std::is_same_v<Archive, cereal::ByteOutputArchive> || std::is_same_v<Archive, cereal::SpanInputArchive>;
+
+    /*Copiable octet par octet et sans padding (aucun octet indéterminé n'est écrit)*/
+    template<class T>
+    inline constexpr bool isFixedLayout = std::is_trivially_copyable_v<T> && std::has_unique_object_representations_v<T>;
+
+    /*À appeler depuis serialize() avec tous les champs, dans l'ordre où ils sont déclarés*/
+    template<class Archive, class T, class... Fields>
+    void record(Archive& ar, T& self, Fields&... fields) {
+        if constexpr (isRawArchive<Archive>) {
+            static_assert(isFixedLayout<T>, "bulk record must be trivially copyable without padding");
+            static_assert(sizeof(T) == (sizeof(Fields) + ...), "bulk record fields must cover the whole object");
+            ar(cereal::binary_data(&self, sizeof(T)));
+        } else {
+            ar(fields...);
+        }
+    }
+
+    template<class Archive, class T, class A>
+    void saveVector(Archive& ar, const std::vector<T, A>& vector) {
+        static_assert(isFixedLayout<T>, "bulk vector element must be trivially copyable without padding");
+        ar(cereal::make_size_tag(static_cast<cereal::size_type>(vector.size())));
+        ar(cereal::binary_data(vector.data(), vector.size() * sizeof(T)));
+    }
+
+    template<class Archive, class T, class A>
+    void loadVector(Archive& ar, std::vector<T, A>& vector) {
+        cereal::size_type size;
+        ar(cereal::make_size_tag(size));
+        if constexpr (requires { ar.remaining(); }) {
+            // Taille annoncée par un pair : refusée avant d'allouer si le payload est trop court
+            if (size > ar.remaining() / sizeof(T)) {
+                throw cereal::Exception("Vector size exceeds remaining payload");
+            }
+        }
+        vector.resize(static_cast<size_t>(size));
+        ar(cereal::binary_data(vector.data(), vector.size() * sizeof(T)));
+    }
+
+}
+
+/*Active l'encodage en bloc de std::vector<Type> (plus spécialisé que la surcharge générique de cereal)*/
+#define BULK_ENCODED_VECTOR(Type)                                                               \
+    namespace cereal {                                                                          \
+        template<class Archive, class A> inline                                                 \
+        std::enable_if_t<bulk::isRawArchive<Archive>>                                           \
+        CEREAL_SAVE_FUNCTION_NAME(Archive& ar, const std::vector<Type, A>& vector) {            \
+            bulk::saveVector(ar, vector);                                                       \
+        }                                                                                       \
+        template<class Archive, class A> inline                                                 \
+        std::enable_if_t<bulk::isRawArchive<Archive>>                                           \
+        CEREAL_LOAD_FUNCTION_NAME(Archive& ar, std::vector<Type, A>& vector) {                  \
+            bulk::loadVector(ar, vector);                                                       \
+        }                                                                                       \
+    }
+
+#endif // BULK_ENCODING_HPP
@@ -0,0 +1,138 @@
+#ifndef BYTE_ARCHIVE_HPP
+#define BYTE_ARCHIVE_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <cereal/cereal.hpp>
+
+/**
+ * Archives cereal binaires sans flux : même format octet pour octet que
+ * BinaryOutputArchive / BinaryInputArchive, mais l'écriture se fait directement
+ * dans un std::vector<uint8_t> et la lecture dans un std::span, sans
+ * ostringstream/istringstream ni copie intermédiaire en std::string.
+ */
+namespace cereal {
+
+    /*Ajoute les octets sérialisés à la fin du buffer fourni (qui peut être réutilisé d'un appel à l'autre)*/
+    class ByteOutputArchive : public OutputArchive<ByteOutputArchive, AllowEmptyClassElision> {
+    public:
+        explicit ByteOutputArchive(std::vector<uint8_t>& buffer)
+            : OutputArchive<ByteOutputArchive, AllowEmptyClassElision>(this), buffer_(buffer) {}
+
+        void saveBinary(const void* data, std::size_t size) {
+            const auto* bytes = static_cast<const uint8_t*>(data);
+            buffer_.insert(buffer_.end(), bytes, bytes + size);
+        }
+
+    private:
+        std::vector<uint8_t>& buffer_;
+    };
+
+    /*Lit directement dans la zone mémoire fournie (elle doit rester valide pendant la lecture)*/
+    class SpanInputArchive : public InputArchive<SpanInputArchive, AllowEmptyClassElision> {
+    public:
+        explicit SpanInputArchive(std::span<const uint8_t> data)
+            : InputArchive<SpanInputArchive, AllowEmptyClassElision>(this), data_(data) {}
+
+        void loadBinary(void* const data, std::size_t size) {
+            if (size > data_.size() - position_) {
+                throw Exception("Failed to read " + std::to_string(size) + " bytes: only "
+                                + std::to_string(data_.size() - position_) + " left");
+            }
+            std::memcpy(data, data_.data() + position_, size);
+            position_ += size;
+        }
+
+        /*Octets pas encore lus*/
+        std::size_t remaining() const { return data_.size() - position_; }
+
+    private:
+        std::span<const uint8_t> data_;
+        std::size_t position_ = 0;
+    };
+
+    template<class T> inline
+    typename std::enable_if<std::is_arithmetic<T>::value, void>::type
+    CEREAL_SAVE_FUNCTION_NAME(ByteOutputArchive& ar, T const& t) {
+        ar.saveBinary(std::addressof(t), sizeof(t));
+    }
+
+    template<class T> inline
+    typename std::enable_if<std::is_arithmetic<T>::value, void>::type
+    CEREAL_LOAD_FUNCTION_NAME(SpanInputArchive& ar, T& t) {
+        ar.loadBinary(std::addressof(t), sizeof(t));
+    }
+
+    template<class Archive, class T> inline
+    CEREAL_ARCHIVE_RESTRICT(SpanInputArchive, ByteOutputArchive)
+    CEREAL_SERIALIZE_FUNCTION_NAME(Archive& ar, NameValuePair<T>& t) {
+        ar(t.value);
+    }
+
+    template<class Archive, class T> inline
+    CEREAL_ARCHIVE_RESTRICT(SpanInputArchive, ByteOutputArchive)
+    CEREAL_SERIALIZE_FUNCTION_NAME(Archive& ar, SizeTag<T>& t) {
+        ar(t.size);
+    }
+
+    template<class T> inline
+    void CEREAL_SAVE_FUNCTION_NAME(ByteOutputArchive& ar, BinaryData<T> const& bd) {
+        ar.saveBinary(bd.data, static_cast<std::size_t>(bd.size));
+    }
+
+    template<class T> inline
+    void CEREAL_LOAD_FUNCTION_NAME(SpanInputArchive& ar, BinaryData<T>& bd) {
+        ar.loadBinary(bd.data, static_cast<std::size_t>(bd.size));
+    }
+
+}
+
+CEREAL_REGISTER_ARCHIVE(cereal::ByteOutputArchive)
+CEREAL_REGISTER_ARCHIVE(cereal::SpanInputArchive)
+
+CEREAL_SETUP_ARCHIVE_TRAITS(cereal::SpanInputArchive, cereal::ByteOutputArchive)
+
+/**
+ * Buffers d'octets réutilisés par thread : la capacité déjà allouée est conservée
+ * entre deux sérialisations (hash d'en-tête à chaque nonce, frames réseau).
+ */
+class PooledBuffer {
+private:
+    static constexpr size_t kMaxPooled = 8;                 // buffers gardés par thread
+    static constexpr size_t kMaxPooledCapacity = 4 << 20;   // au-delà, le buffer est libéré
+
+    static std::vector<std::vector<uint8_t>>& pool() {
+        thread_local std::vector<std::vector<uint8_t>> buffers;
+        return buffers;
+    }
+
+    std::vector<uint8_t> buffer_;
+
+public:
+    PooledBuffer() {
+        auto& buffers = pool();
+        if (!buffers.empty()) {
+            buffer_ = std::move(buffers.back());
+            buffers.pop_back();
+        }
+    }
+    ~PooledBuffer() {
+        auto& buffers = pool();
+        if (buffer_.capacity() <= kMaxPooledCapacity && buffers.size() < kMaxPooled) {
+            buffer_.clear();
+            buffers.push_back(std::move(buffer_));
+        }
+    }
+    PooledBuffer(const PooledBuffer&) = delete;
+    PooledBuffer& operator=(const PooledBuffer&) = delete;
+
+    std::vector<uint8_t>& get() { return buffer_; }
+    std::span<const uint8_t> bytes() const { return buffer_; }
+};
+
+#endif // BYTE_ARCHIVE_HPP
@@ -0,0 +1,191 @@
+#ifndef COMPACT_ARCHIVE_HPP
+#define COMPACT_ARCHIVE_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <cereal/cereal.hpp>
+
+/*Entiers à longueur variable (LEB128) : 7 bits par octet, bit de poids fort = "octet suivant"*/
+namespace varint {
+
+    constexpr size_t kMaxBytes = 10; // uint64_t
+
+    inline void write(std::vector<uint8_t>& out, uint64_t value) {
+        uint8_t bytes[kMaxBytes];
+        size_t n = 0;
+        while (value >= 0x80) {
+            bytes[n++] = static_cast<uint8_t>(value) | 0x80;
+            value >>= 7;
+        }
+        bytes[n++] = static_cast<uint8_t>(value);
+        out.insert(out.end(), bytes, bytes + n);
+    }
+
+    /*Lit un varint à partir de position ; lève cereal::Exception si tronqué ou plus long que 64 bits*/
+    inline uint64_t read(std::span<const uint8_t> data, size_t& position) {
+        uint64_t value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            if (position >= data.size()) {
+                throw cereal::Exception("Truncated varint");
+            }
+            const uint8_t byte = data[position++];
+            if (shift == 63 && byte > 1) {
+                throw cereal::Exception("Varint overflows 64 bits");
+            }
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                return value;
+            }
+        }
+        throw cereal::Exception("Varint overflows 64 bits");
+    }
+
+    /*Signés : 0, -1, 1, -2... -> 0, 1, 2, 3... (les petites valeurs négatives restent courtes)*/
+    inline constexpr uint64_t zigzag(int64_t value) {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+    inline constexpr int64_t unzigzag(uint64_t value) {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+}
+
+/**
+ * Archives cereal compactes (protocole v3) : tous les entiers de plus d'un octet
+ * (longueurs de vecteurs, index, montants, nonce...) sont écrits en varint, les
+ * signés en zigzag. Les octets isolés, flottants et blocs binaires (hashs, clés,
+ * signatures) restent bruts. Format réseau uniquement : le hash des blocs et les
+ * txids sont calculés sur le format à taille fixe (ByteOutputArchive).
+ */
+namespace cereal {
+
+    class CompactOutputArchive : public OutputArchive<CompactOutputArchive, AllowEmptyClassElision> {
+    public:
+        explicit CompactOutputArchive(std::vector<uint8_t>& buffer)
+            : OutputArchive<CompactOutputArchive, AllowEmptyClassElision>(this), buffer_(buffer) {}
+
+        void saveBinary(const void* data, std::size_t size) {
+            const auto* bytes = static_cast<const uint8_t*>(data);
+            buffer_.insert(buffer_.end(), bytes, bytes + size);
+        }
+        void saveVarint(uint64_t value) { varint::write(buffer_, value); }
+
+    private:
+        std::vector<uint8_t>& buffer_;
+    };
+
+    class CompactInputArchive : public InputArchive<CompactInputArchive, AllowEmptyClassElision> {
+    public:
+        explicit CompactInputArchive(std::span<const uint8_t> data)
+            : InputArchive<CompactInputArchive, AllowEmptyClassElision>(this), data_(data) {}
+
+        void loadBinary(void* const data, std::size_t size) {
+            if (size > data_.size() - position_) {
+                throw Exception("Failed to read " + std::to_string(size) + " bytes: only "
+                                + std::to_string(data_.size() - position_) + " left");
+            }
+            std::memcpy(data, data_.data() + position_, size);
+            position_ += size;
+        }
+        uint64_t loadVarint() { return varint::read(data_, position_); }
+
+        /*Octets pas encore lus*/
+        std::size_t remaining() const { return data_.size() - position_; }
+
+    private:
+        std::span<const uint8_t> data_;
+        std::size_t position_ = 0;
+    };
+
+    namespace compact {
+        template<class T>
+        inline constexpr bool isVarint = std::is_integral_v<T> && !std::is_same_v<T, bool> && (sizeof(T) > 1);
+    }
+
+    // Octets, booléens et flottants : bruts
+    template<class T> inline
+    std::enable_if_t<std::is_arithmetic_v<T> && !compact::isVarint<T>>
+    CEREAL_SAVE_FUNCTION_NAME(CompactOutputArchive& ar, T const& t) {
+        ar.saveBinary(std::addressof(t), sizeof(t));
+    }
+
+    template<class T> inline
+    std::enable_if_t<std::is_arithmetic_v<T> && !compact::isVarint<T>>
+    CEREAL_LOAD_FUNCTION_NAME(CompactInputArchive& ar, T& t) {
+        ar.loadBinary(std::addressof(t), sizeof(t));
+    }
+
+    // Entiers : varint (zigzag pour les signés), valeur hors du type refusée à la lecture
+    template<class T> inline
+    std::enable_if_t<compact::isVarint<T>>
+    CEREAL_SAVE_FUNCTION_NAME(CompactOutputArchive& ar, T const& t) {
+        if constexpr (std::is_signed_v<T>) {
+            ar.saveVarint(varint::zigzag(t));
+        } else {
+            ar.saveVarint(t);
+        }
+    }
+
+    template<class T> inline
+    std::enable_if_t<compact::isVarint<T>>
+    CEREAL_LOAD_FUNCTION_NAME(CompactInputArchive& ar, T& t) {
+        const uint64_t raw = ar.loadVarint();
+        if constexpr (std::is_signed_v<T>) {
+            const int64_t value = varint::unzigzag(raw);
+            if (value < std::numeric_limits<T>::min() || value > std::numeric_limits<T>::max()) {
+                throw Exception("Varint out of range");
+            }
+            t = static_cast<T>(value);
+        } else {
+            if (raw > std::numeric_limits<T>::max()) {
+                throw Exception("Varint out of range");
+            }
+            t = static_cast<T>(raw);
+        }
+    }
+
+    template<class Archive, class T> inline
+    CEREAL_ARCHIVE_RESTRICT(CompactInputArchive, CompactOutputArchive)
+    CEREAL_SERIALIZE_FUNCTION_NAME(Archive& ar, NameValuePair<T>& t) {
+        ar(t.value);
+    }
+
+    template<class T> inline
+    void CEREAL_SAVE_FUNCTION_NAME(CompactOutputArchive& ar, SizeTag<T> const& t) {
+        ar.saveVarint(static_cast<uint64_t>(t.size));
+    }
+
+    // Chaque élément occupe au moins un octet : une taille annoncée plus grande que le reste du payload est refusée avant l'allocation
+    template<class T> inline
+    void CEREAL_LOAD_FUNCTION_NAME(CompactInputArchive& ar, SizeTag<T>& t) {
+        const uint64_t size = ar.loadVarint();
+        if (size > ar.remaining()) {
+            throw Exception("Size exceeds remaining payload");
+        }
+        t.size = static_cast<std::remove_reference_t<T>>(size);
+    }
+
+    template<class T> inline
+    void CEREAL_SAVE_FUNCTION_NAME(CompactOutputArchive& ar, BinaryData<T> const& bd) {
+        ar.saveBinary(bd.data, static_cast<std::size_t>(bd.size));
+    }
+
+    template<class T> inline
+    void CEREAL_LOAD_FUNCTION_NAME(CompactInputArchive& ar, BinaryData<T>& bd) {
+        ar.loadBinary(bd.data, static_cast<std::size_t>(bd.size));
+    }
+
+}
+
+CEREAL_REGISTER_ARCHIVE(cereal::CompactOutputArchive)
+CEREAL_REGISTER_ARCHIVE(cereal::CompactInputArchive)
+
+CEREAL_SETUP_ARCHIVE_TRAITS(cereal::CompactInputArchive, cereal::CompactOutputArchive)
+
+#endif // COMPACT_ARCHIVE_HPP
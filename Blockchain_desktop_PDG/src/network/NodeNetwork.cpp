@@ -4,16 +4,6 @@
 #include <chrono>
 
 
-void NodeNetwork::broadcastBack(const std::string& raw, const PeerInfo& exclude){
-    std::string s = raw;
-    for (auto& [peer, c] : peers_)
-        if (peer != exclude)
-            c->send(s);
-    for (auto& [peer, c] : incoming_)
-        if (peer != exclude)
-            c->send(s);
-}
-
 void NodeNetwork::handleMessage(const PeerInfo& peer, const std::string& raw){
     // Un raw peut contenir exactement un frame (TcpConnection garantit framing length-only; ici header binaire custom) :
     if (raw.size() < sizeof(MsgHeader))
@@ -44,6 +34,7 @@ void NodeNetwork::handleMessage(const PeerInfo& peer, const std::string& raw){
                 }
 
                 sendAck(peer);
+                sendNegotiate(peer);
             }
             break;
         }
@@ -58,6 +49,14 @@ void NodeNetwork::handleMessage(const PeerInfo& peer, const std::string& raw){
                 else
                     isSynchronized();
 
+                sendNegotiate(peer);
+            }
+            break;
+        }
+        case MsgType::NEGOTIATE: {
+            if (h.length == sizeof(uint8_t) && payload[0] >= MIN_PROTOCOL_VERSION) {
+                // Les deux côtés envoient leur version max : chacun retient la plus petite des deux
+                peerVersions_[peer] = std::min(payload[0], PROTOCOL_VERSION);
             }
             break;
         }
@@ -70,7 +69,7 @@ void NodeNetwork::handleMessage(const PeerInfo& peer, const std::string& raw){
         }
         case MsgType::BLOCK: {
             try {
-                Block b = BinaryProtocol::deserializeObject<Block>(payload, h.length);
+                Block b = BinaryProtocol::deserializeObject<Block>(payload, h.length, h.version);
 
 
                 if(blockchain_.addBlock(b)) {
@@ -88,10 +87,11 @@ void NodeNetwork::handleMessage(const PeerInfo& peer, const std::string& raw){
         case MsgType::BROADCAST_TX: {
 
             try {
-                Transaction tx = BinaryProtocol::deserializeObject<Transaction>(payload, h.length);
+                Transaction tx = BinaryProtocol::deserializeObject<Transaction>(payload, h.length, h.version);
 
-                if (blockchain_.getTransactionPool().addTransaction(tx)) {
-                    broadcastBack(raw, peer);
+                // Vérification et relais hors du thread réseau (AdmissionQueue) : un afflux de transactions ne bloque plus les blocs
+                if (!blockchain_.getTransactionPool().contains(tx.getTxid())) {
+                    blockchain_.submitTransaction(std::move(tx), peer);
                 }
             } catch(...) {}
             break;
@@ -99,10 +99,10 @@ void NodeNetwork::handleMessage(const PeerInfo& peer, const std::string& raw){
         case MsgType::BROADCAST_BLOCK: {
 
             try {
-                Block b = BinaryProtocol::deserializeObject<Block>(payload, h.length);
+                Block b = BinaryProtocol::deserializeObject<Block>(payload, h.length, h.version);
 
                 if (blockchain_.addBlock(b)) {
-                    broadcastBack(raw, peer);
+                    broadcastBack(raw, h, b, peer);
                 } else if (h.localSize > blockchain_.size() + 1) {
                     requestBlock(peer, blockchain_.size());
                 }
@@ -114,13 +114,21 @@ void NodeNetwork::handleMessage(const PeerInfo& peer, const std::string& raw){
     }
 }
 
+void NodeNetwork::relayTransaction(const Transaction& tx, const PeerInfo& from){
+    boost::asio::post(io_, [this, tx, from]{
+        EncodedFrames frames;
+        broadcastEncoded(MsgType::BROADCAST_TX, tx, frames, &from);
+    });
+}
+
 void NodeNetwork::handleDisconnect(const PeerInfo& peer){
     size_t erased = peers_.erase(peer); // pour outgoing
     if (!erased) erased = incoming_.erase(peer); // pour incoming
     if (erased) peerCount_.fetch_sub(1, std::memory_order_relaxed);
+    peerVersions_.erase(peer);
 }
 
-void NodeNetwork::buildAndSendFrame(const PeerInfo& peer, MsgType type, const std::vector<uint8_t>& payload){
+void NodeNetwork::buildAndSendFrame(const PeerInfo& peer, MsgType type, std::span<const uint8_t> payload){
     auto it = peers_.find(peer);
     if (it == peers_.end()){
         it = incoming_.find(peer);
@@ -128,9 +136,12 @@ void NodeNetwork::buildAndSendFrame(const PeerInfo& peer, MsgType type, const st
             return; // si le peer n'est pas trouvé
     }
 
-    auto frame = BinaryProtocol::buildFrame(type, blockchain_.size(), payload);
-    std::string s(reinterpret_cast<const char*>(frame.data()), frame.size());
-    it->second->send(s);
+    it->second->send(frameToString(type, payload, peerVersion(peer)));
+}
+
+std::string NodeNetwork::frameToString(MsgType type, std::span<const uint8_t> payload, uint8_t version) const{
+    auto frame = BinaryProtocol::buildFrame(type, blockchain_.size(), payload, version);
+    return std::string(reinterpret_cast<const char*>(frame.data()), frame.size());
 }
 
 void NodeNetwork::sendVersion(const PeerInfo& peer){
@@ -147,10 +158,16 @@ void NodeNetwork::sendAck(const PeerInfo& peer){
     buildAndSendFrame(peer, MsgType::ACK, payload);
 }
 
+void NodeNetwork::sendNegotiate(const PeerInfo& peer){
+    const uint8_t maxVersion = PROTOCOL_VERSION;
+    buildAndSendFrame(peer, MsgType::NEGOTIATE, std::span<const uint8_t>(&maxVersion, 1));
+}
+
 void NodeNetwork::sendBlock(const PeerInfo& peer, uint32_t blockIdx){
     const auto& block = blockchain_[blockIdx];
-    auto payload = BinaryProtocol::serializeObject<Block>(block);
-    buildAndSendFrame(peer, MsgType::BLOCK, payload);
+    PooledBuffer payload;
+    BinaryProtocol::serializeInto(block, payload.get(), peerVersion(peer));
+    buildAndSendFrame(peer, MsgType::BLOCK, payload.bytes());
 }
 
 void NodeNetwork::requestBlock(const PeerInfo& peer, uint32_t blockIdx){
@@ -162,11 +179,12 @@ void NodeNetwork::requestBlock(const PeerInfo& peer, uint32_t blockIdx){
 }
 
 
-void NodeNetwork::buildFrameAndbroadcast(MsgType type, const std::vector<uint8_t>& payload){
-    auto frame = BinaryProtocol::buildFrame(type, blockchain_.size(), payload);
-    std::string s(reinterpret_cast<const char*>(frame.data()), frame.size());
-    for (auto& [peer, c] : peers_)
-        c->send(s);
-    for (auto& [peer, c] : incoming_)
-        c->send(s);
+void NodeNetwork::buildFrameAndbroadcast(MsgType type, std::span<const uint8_t> payload){
+    // Payload déjà encodé par l'appelant au format de base, compris par tous les pairs
+    boost::asio::post(io_, [this, s = frameToString(type, payload, MIN_PROTOCOL_VERSION)]{
+        for (auto& [peer, c] : peers_)
+            c->send(s);
+        for (auto& [peer, c] : incoming_)
+            c->send(s);
+    });
 }
\ No newline at end of file
@@ -2,6 +2,8 @@
 #define NODE_NETWORK_HPP
 
 #include <boost/asio.hpp>
+#include <algorithm>
+#include <array>
 #include <thread>
 #include <unordered_map>
 #include <unordered_set>
@@ -20,6 +22,7 @@
 #include <miniupnpc/upnperrors.h>
 
 class Blockchain;
+class Transaction;
 
 // Exemple complet d'un mini gestionnaire de réseau avec handshake + ping
 class NodeNetwork {
@@ -87,14 +90,20 @@ public:
 
     int peerCount() const { return peerCount_.load(); }
 
-    void buildFrameAndbroadcast(MsgType type, const std::vector<uint8_t>& payload);
+    /*Diffuse à tous les pairs (appelable de n'importe quel thread : exécuté sur le thread réseau, seul à lire peers_ et peerVersions_)*/
+    void buildFrameAndbroadcast(MsgType type, std::span<const uint8_t> payload);
 
     template<typename T>
     void buildFrameAndbroadcast(MsgType type, const T& obj) {
-        auto payload = BinaryProtocol::serializeObject(obj);
-        buildFrameAndbroadcast(type, payload);
+        boost::asio::post(io_, [this, type, obj]{
+            EncodedFrames frames;
+            broadcastEncoded(type, obj, frames, nullptr);
+        });
     }
 
+    /*Relaie une transaction admise à tous les pairs sauf from (appelable de n'importe quel thread : exécuté sur le thread réseau)*/
+    void relayTransaction(const Transaction& tx, const PeerInfo& from);
+
 private:
 
     Blockchain& blockchain_;
@@ -105,6 +114,7 @@ private:
 
     std::unordered_map<PeerInfo, ConnPtr> peers_; // connexions sortantes
     std::unordered_map<PeerInfo, ConnPtr> incoming_; // connexions entrantes
+    std::unordered_map<PeerInfo, uint8_t> peerVersions_; // version négociée (NEGOTIATE), MIN_PROTOCOL_VERSION sinon
     std::atomic<bool> isRunning_;
 
     std::atomic<int> peerCount_{0};
@@ -143,17 +153,56 @@ private:
         );
     }
 
-    void broadcastBack(const std::string& raw, const PeerInfo& exclude);
+    /*Frames d'un même message, une par version de protocole, encodées à la première utilisation*/
+    using EncodedFrames = std::array<std::string, PROTOCOL_VERSION - MIN_PROTOCOL_VERSION + 1>;
+
+    uint8_t peerVersion(const PeerInfo& peer) const {
+        auto it = peerVersions_.find(peer);
+        return it == peerVersions_.end() ? MIN_PROTOCOL_VERSION : it->second;
+    }
+
+    std::string frameToString(MsgType type, std::span<const uint8_t> payload, uint8_t version) const;
+
+    /*Envoie obj à chaque pair (sauf exclude) dans sa version négociée : une seule sérialisation par version*/
+    template<typename T>
+    void broadcastEncoded(MsgType type, const T& obj, EncodedFrames& frames, const PeerInfo* exclude) {
+        auto sendTo = [&](const PeerInfo& peer, const ConnPtr& c) {
+            if (exclude && peer == *exclude)
+                return;
+            const uint8_t version = peerVersion(peer);
+            std::string& frame = frames[version - MIN_PROTOCOL_VERSION];
+            if (frame.empty()) {
+                PooledBuffer payload;
+                BinaryProtocol::serializeInto(obj, payload.get(), version);
+                frame = frameToString(type, payload.bytes(), version);
+            }
+            c->send(frame);
+        };
+        for (auto& [peer, c] : peers_)
+            sendTo(peer, c);
+        for (auto& [peer, c] : incoming_)
+            sendTo(peer, c);
+    }
+
+    /*Relaie un message reçu : la frame d'origine est réutilisée telle quelle pour les pairs de même version*/
+    template<typename T>
+    void broadcastBack(const std::string& raw, const MsgHeader& h, const T& obj, const PeerInfo& exclude) {
+        EncodedFrames frames;
+        frames[h.version - MIN_PROTOCOL_VERSION] = raw;
+        broadcastEncoded(static_cast<MsgType>(h.type), obj, frames, &exclude);
+    }
 
     void handleMessage(const PeerInfo& peer, const std::string& raw);
     void handleDisconnect(const PeerInfo& peer);
 
-    void buildAndSendFrame(const PeerInfo& peer, MsgType type, const std::vector<uint8_t>& payload);
+    void buildAndSendFrame(const PeerInfo& peer, MsgType type, std::span<const uint8_t> payload);
 
     void sendVersion(const PeerInfo& peer);
 
     void sendAck(const PeerInfo& peer);
 
+    void sendNegotiate(const PeerInfo& peer);
+
     void sendBlock(const PeerInfo& peer, uint32_t blockIdx);
 
     void requestBlock(const PeerInfo& peer, uint32_t blockIdx);
@@ -0,0 +1,104 @@
+#include "network/OrphanPool.hpp"
+
+#include <algorithm>
+
+bool OrphanPool::add(const Transaction& tx, const PeerInfo& from, Clock::time_point now) {
+    // Sorties attendues : celles des parents non confirmés référencés par les inputs
+    std::vector<OutPoint> missing;
+    for (const auto& input : tx.getInputs()) {
+        if (input.isUnconfirmed() && input.getTxIndex() < tx.getParents().size()) {
+            missing.push_back(OutPoint{tx.getParents()[input.getTxIndex()], input.getOutputIndex()});
+        }
+    }
+    if (missing.empty()) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    expire_NoLock(now);
+    const Hash txid = tx.getTxid();
+    if (orphans_.count(txid) > 0) {
+        return false;
+    }
+    if (perPeer_[from] >= kMaxPerPeer) {
+        ++rejectedPeerLimit_;
+        return false;
+    }
+    if (orphans_.size() >= kMaxOrphans) {
+        auto oldest = std::min_element(orphans_.begin(), orphans_.end(), [](const auto& a, const auto& b) {
+            return a.second.expiry < b.second.expiry;
+        });
+        erase_NoLock(oldest);
+        ++evicted_;
+    }
+
+    for (const auto& outPoint : missing) {
+        byOutPoint_[outPoint].push_back(txid);
+    }
+    ++perPeer_[from];
+    orphans_.emplace(txid, Entry{Orphan{tx, from}, now + kExpiry, std::move(missing)});
+    return true;
+}
+
+std::vector<OrphanPool::Orphan> OrphanPool::takeChildren(const Transaction& parent) {
+    std::vector<Orphan> children;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (orphans_.empty()) {
+        return children;
+    }
+    const Hash txid = parent.getTxid();
+    for (size_t i = 0; i < parent.getOutputs().size(); ++i) {
+        auto waiting = byOutPoint_.find(OutPoint{txid, static_cast<uint16_t>(i)});
+        if (waiting == byOutPoint_.end()) {
+            continue;
+        }
+        const std::vector<Hash> childTxids = waiting->second; // copie : erase_NoLock modifie l'index
+        for (const auto& childTxid : childTxids) {
+            auto it = orphans_.find(childTxid);
+            if (it != orphans_.end()) {
+                children.push_back(it->second.orphan); // copie : erase_NoLock lit encore le pair
+                erase_NoLock(it);
+            }
+        }
+    }
+    return children;
+}
+
+OrphanPool::Stats OrphanPool::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats s;
+    s.count = orphans_.size();
+    s.expired = expired_;
+    s.evicted = evicted_;
+    s.rejectedPeerLimit = rejectedPeerLimit_;
+    return s;
+}
+
+void OrphanPool::erase_NoLock(EntryMap::iterator it) {
+    for (const auto& outPoint : it->second.missing) {
+        auto waiting = byOutPoint_.find(outPoint);
+        if (waiting == byOutPoint_.end()) {
+            continue;
+        }
+        std::erase(waiting->second, it->first);
+        if (waiting->second.empty()) {
+            byOutPoint_.erase(waiting);
+        }
+    }
+    auto peer = perPeer_.find(it->second.orphan.from);
+    if (peer != perPeer_.end() && --peer->second == 0) {
+        perPeer_.erase(peer);
+    }
+    orphans_.erase(it);
+}
+
+void OrphanPool::expire_NoLock(Clock::time_point now) {
+    for (auto it = orphans_.begin(); it != orphans_.end();) {
+        if (it->second.expiry <= now) {
+            erase_NoLock(it++);
+            ++expired_;
+        } else {
+            ++it;
+        }
+    }
+}
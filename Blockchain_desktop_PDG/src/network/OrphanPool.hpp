@@ -0,0 +1,73 @@
+#ifndef ORPHAN_POOL_HPP
+#define ORPHAN_POOL_HPP
+
+#include "transaction/Transaction.hpp"
+#include "network/PeerInfo.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Transactions reçues avant leur parent non confirmé. Indexées par sortie manquante : quand un
+ * parent est accepté, ses enfants en attente sont retrouvés en une recherche par sortie et
+ * réévalués aussitôt, au lieu d'être perdus puis rediffusés. Bornée en nombre (total et par
+ * pair) et en durée : un pair ne peut pas remplir la mémoire avec des parents qui n'arrivent jamais.
+ */
+class OrphanPool {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Orphan {
+        Transaction tx;
+        PeerInfo from;
+    };
+
+    struct Stats {
+        size_t count = 0;
+        uint64_t expired = 0;
+        uint64_t evicted = 0;          // plus ancienne retirée, pool pleine
+        uint64_t rejectedPeerLimit = 0;
+    };
+
+    static constexpr size_t kMaxOrphans = 100;
+    static constexpr size_t kMaxPerPeer = 25;
+    static constexpr std::chrono::minutes kExpiry{20};
+
+    /*Met tx en attente de ses parents. False si elle ne dépend d'aucun parent non confirmé, est déjà là ou si le pair a atteint sa limite*/
+    bool add(const Transaction& tx, const PeerInfo& from, Clock::time_point now = Clock::now());
+    /*Retire et retourne les orphelines qui dépensent une sortie de parent*/
+    std::vector<Orphan> takeChildren(const Transaction& parent);
+    bool contains(const Hash& txid) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return orphans_.count(txid) > 0;
+    }
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return orphans_.size();
+    }
+    Stats getStats() const;
+
+private:
+    struct Entry {
+        Orphan orphan;
+        Clock::time_point expiry;
+        std::vector<OutPoint> missing; // sorties des parents non confirmés (clés de byOutPoint_)
+    };
+    using EntryMap = std::unordered_map<Hash, Entry>;
+
+    EntryMap orphans_;
+    std::unordered_map<OutPoint, std::vector<Hash>> byOutPoint_;
+    std::unordered_map<PeerInfo, size_t> perPeer_;
+    uint64_t expired_ = 0;
+    uint64_t evicted_ = 0;
+    uint64_t rejectedPeerLimit_ = 0;
+    mutable std::mutex mutex_;
+
+    void erase_NoLock(EntryMap::iterator it);
+    void expire_NoLock(Clock::time_point now);
+};
+
+#endif // ORPHAN_POOL_HPP
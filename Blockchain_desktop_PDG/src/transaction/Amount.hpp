@@ -0,0 +1,45 @@
+#ifndef AMOUNT_HPP
+#define AMOUNT_HPP
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+/*Montant en unités de base entières (1 SKBC = COIN unités) : sommes exactes et indépendantes de l'ordre*/
+using Amount = int64_t;
+
+constexpr Amount COIN = 100'000'000;
+/*Borne de toute somme valide (supply max ~2 millions de SKBC, voir getMiningRewardAt)*/
+constexpr Amount MAX_MONEY = 2'000'000 * COIN;
+
+inline constexpr bool isValidAmount(Amount value) { return value >= 0 && value <= MAX_MONEY; }
+
+/*Addition vérifiée : lève std::overflow_error si un opérande ou le résultat sort de [0, MAX_MONEY]*/
+inline constexpr Amount checkedAdd(Amount a, Amount b) {
+    if (!isValidAmount(a) || !isValidAmount(b) || a > MAX_MONEY - b) {
+        throw std::overflow_error("Amount out of range");
+    }
+    return a + b;
+}
+
+/*Soustraction vérifiée : lève std::overflow_error si le résultat est négatif*/
+inline constexpr Amount checkedSub(Amount a, Amount b) {
+    if (!isValidAmount(a) || !isValidAmount(b) || b > a) {
+        throw std::overflow_error("Amount out of range");
+    }
+    return a - b;
+}
+
+/*Conversion depuis des SKBC (saisie utilisateur, ancien format double), arrondie à l'unité la plus proche*/
+inline Amount amountFromCoins(double coins) {
+    if (!std::isfinite(coins) || coins < 0 || coins > static_cast<double>(MAX_MONEY / COIN)) {
+        throw std::invalid_argument("Invalid amount");
+    }
+    return static_cast<Amount>(std::llround(coins * static_cast<double>(COIN)));
+}
+
+/*Conversion en SKBC pour l'affichage uniquement*/
+inline double amountToCoins(Amount value) { return static_cast<double>(value) / static_cast<double>(COIN); }
+
+#endif // AMOUNT_HPP
@@ -1,44 +1,103 @@
 #include "BlockTransactions.hpp"
 #include "Blockchain.hpp"
+#include "cryptography/VerificationPool.hpp"
+#include "cryptography/Sha256.hpp"
 
+#include <unordered_set>
 
-BlockTransactions::BlockTransactions(const Blockchain& blockchain, const TransactionPool& pool, const PubKey& minerPubKey) : txs() {
-    double totalFees = 0.0;
-    txs.reserve(MAX_TRANSACTIONS + 1);
-
-    size_t count = 0;
-    
-    for (const auto& tx : pool.getTransactions()) {
-        if (count >= MAX_TRANSACTIONS) break;
 
-        totalFees += tx.getFee(blockchain);
-        txs.push_back(tx);
-        ++count;
+BlockTransactions::BlockTransactions(const Blockchain& blockchain, const TransactionPool& pool, const PubKey& minerPubKey) : txs() {
+    // Modèle tenu à jour par la pool (mieux payées d'abord, parents avant enfants, frais déjà sommés) :
+    // simple chargement atomique s'il est inchangé depuis le dernier bloc
+    const auto block = pool.blockTemplate();
+    txs.reserve(block->entries.size() + 1);
+    for (const auto& entry : block->entries) {
+        txs.push_back(entry->tx);
     }
 
-    txs.push_back(Transaction::miningReward(minerPubKey, totalFees + Blockchain::getMiningRewardAt(blockchain.size())));
+    txs.push_back(Transaction::miningReward(minerPubKey, checkedAdd(block->fees, Blockchain::getMiningRewardAt(blockchain.size())), blockchain.size()));
 }
 
-double BlockTransactions::getTotalFees(const Blockchain& blockchain) const {
-    double totalFees = 0.0;
+Amount BlockTransactions::getTotalFees(const Blockchain& blockchain) const {
+    Amount totalFees = 0;
+    PendingTxs earlier; // une transaction peut dépenser une sortie d'une transaction précédente du bloc
     for (size_t i = 0; i < txs.size() - 1; ++i) { // Ignore last tx (mining reward)
-        totalFees += txs[i].getFee(blockchain);
+        totalFees = checkedAdd(totalFees, txs[i].getFee(blockchain, &earlier));
+        earlier.emplace(txs[i].getTxid(), &txs[i]);
     }
     return totalFees;
 }
 
-double BlockTransactions::calculateMinerReward(const Blockchain& blockchain, const Block& block){
-    return blockchain.getMiningRewardAt(block.getIndex()) + block.getBlockTransactions().getTotalFees(blockchain);
+size_t BlockTransactions::getTransactionBytes() const {
+    size_t bytes = 0;
+    for (size_t i = 0; i + 1 < txs.size(); ++i) { // Ignore last tx (mining reward)
+        bytes += txs[i].getSize();
+    }
+    return bytes;
+}
+
+Hash BlockTransactions::computeMerkleRoot() const {
+    if (txs.empty()) {
+        return Hash{};
+    }
+    std::vector<Hash> level;
+    level.reserve(txs.size() + 1);
+    for (const auto& tx : txs) {
+        level.push_back(tx.getTxid());
+    }
+
+    // Chaque niveau : paires de 64 octets hachées en lot (8 par 8 avec le back end AVX2)
+    std::vector<std::span<const uint8_t>> pairs;
+    while (level.size() > 1) {
+        if (level.size() % 2 != 0) {
+            level.push_back(level.back()); // nombre impair : le dernier est apparié avec lui-même
+        }
+        pairs.clear();
+        for (size_t i = 0; i < level.size(); i += 2) {
+            pairs.emplace_back(level[i].data(), 2 * Hash::SIZE);
+        }
+        std::vector<Hash> parents(pairs.size());
+        sha256::hashMany(pairs, parents.front().data());
+        level = std::move(parents);
+    }
+    return level.front();
+}
+
+Amount BlockTransactions::calculateMinerReward(const Blockchain& blockchain, const Block& block){
+    return checkedAdd(blockchain.getMiningRewardAt(block.getIndex()), block.getBlockTransactions().getTotalFees(blockchain));
 }
 
 bool BlockTransactions::verify(const Blockchain& blockchain, const Block& block, const UTXOs& utxos) const {
+    if (txs.empty() || getTransactionBytes() > MAX_BLOCK_BYTES) {
+        return false;
+    }
+
+    // Vérifications dépendant de l'état (UTXOs, soldes) : séquentielles et dans l'ordre du bloc.
+    // Un parent non confirmé doit précéder son enfant dans le bloc ; aucune sortie n'est dépensée deux fois par le bloc
+    std::vector<PubKey> owners;
+    owners.reserve(txs.size() - 1);
+    PendingTxs earlier;
+    std::unordered_set<OutPoint> spent;
     for (size_t i = 0; i < txs.size() - 1; ++i) { // Ignore last tx (mining reward)
-        if (!txs[i].verify(blockchain, utxos)) {
+        if (!txs[i].verifyWithoutSignature(blockchain, utxos, &earlier)) {
             return false;
         }
+        for (size_t k = 0; k < txs[i].getInputs().size(); ++k) {
+            if (!spent.insert(txs[i].resolveInput(k, blockchain, &earlier).outPoint).second) {
+                return false;
+            }
+        }
+        owners.push_back(txs[i].resolveInput(0, blockchain, &earlier).output->getPubKey());
+        if (!earlier.emplace(txs[i].getTxid(), &txs[i]).second) {
+            return false; // même transaction deux fois
+        }
     }
     if (!txs.back().verifyMiningReward(blockchain, block)) {
         return false;
     }
-    return true;
+
+    // Signatures (ECDSA) : indépendantes entre elles, réparties sur tous les coeurs
+    return VerificationPool::instance().run(owners.size(), [this, &owners](size_t i) {
+        return txs[i].verifySignature(owners[i]);
+    });
 }
\ No newline at end of file
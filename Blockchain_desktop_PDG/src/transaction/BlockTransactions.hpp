@@ -7,8 +7,10 @@
 #include <cereal/types/vector.hpp>
 
 #include "transaction/TransactionPool.hpp"
+#include "config.hpp"
 
-#define MAX_TRANSACTIONS 10
+// Une transaction fait plus de 100 octets : l'index d'une transaction dans un bloc tient dans OutputReference::txIndex (uint16_t)
+static_assert(MAX_BLOCK_BYTES / 100 < 65535, "MAX_BLOCK_BYTES too large for 16-bit transaction indices");
 
 
 /*Cette object représente un ensemble de transactions à inclure dans un bloc. Elle est responsable de verifier la validité des transactions et de gerer les récompense de minage.*/
@@ -16,25 +18,36 @@ class BlockTransactions {
 private:
     std::vector<Transaction> txs;
 
+    Memoized<Hash> merkleRoot_; // racine de l'arbre de Merkle des txids, calculée une fois
+
+    Hash computeMerkleRoot() const;
+
 public:
 
     BlockTransactions() = default;
     BlockTransactions(const Blockchain& blockchain, const TransactionPool& pool, const PubKey& minerPubKey);
 
-    static double calculateMinerReward(const Blockchain& blockchain, const Block& block);
+    static Amount calculateMinerReward(const Blockchain& blockchain, const Block& block);
 
     //Operator
     const Transaction& operator[](size_t i) const { return txs[i]; }
 
     //Getters
     size_t size() const { return txs.size(); }
-    double getTotalFees(const Blockchain& blockchain) const;
+    /*Octets sérialisés des transactions hors récompense de minage, bornés par MAX_BLOCK_BYTES*/
+    size_t getTransactionBytes() const;
+    Amount getTotalFees(const Blockchain& blockchain) const;
+    /*Racine de l'arbre de Merkle des txids : engage toutes les transactions dans l'en-tête du bloc*/
+    Hash getMerkleRoot() const { return merkleRoot_.get([this] { return computeMerkleRoot(); }); }
 
     bool verify(const Blockchain& blockchain, const Block& block, const UTXOs& unspentOutputs) const;
 
     template<class Archive>
     void serialize(Archive& ar){
         ar(txs);
+        if constexpr (Archive::is_loading::value) {
+            merkleRoot_.reset();
+        }
     }
 
 };
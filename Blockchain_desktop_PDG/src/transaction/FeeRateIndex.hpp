@@ -0,0 +1,115 @@
+#ifndef FEE_RATE_INDEX_HPP
+#define FEE_RATE_INDEX_HPP
+
+#include "cryptography/FixedBytes.hpp"
+#include "transaction/Amount.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <set>
+#include <vector>
+
+/*Frais par octet, comparés exactement par produit en croix (fee <= MAX_MONEY et size de quelques Ko : pas de dépassement int64)*/
+struct FeeRate {
+    Amount fee = 0;
+    uint32_t size = 1;
+
+    bool operator>(const FeeRate& other) const {
+        return fee * static_cast<Amount>(other.size) > other.fee * static_cast<Amount>(size);
+    }
+    bool operator==(const FeeRate& other) const {
+        return fee * static_cast<Amount>(other.size) == other.fee * static_cast<Amount>(size);
+    }
+};
+
+// Entrées trop grosses pour la place restante tolérées à la suite avant d'arrêter le remplissage
+constexpr size_t kMaxSelectionMisses = 1000;
+
+/**
+ * Remplit maxBytes en parcourant des éléments déjà triés par taux de frais décroissant (glouton du
+ * sac à dos fractionnaire) : un élément qui ne rentre plus est sauté et les suivants, plus petits,
+ * peuvent encore combler la place restante. Arrêt après kMaxSelectionMisses sauts consécutifs.
+ * rateOf(élément) donne son FeeRate, take(élément) est appelé pour chaque élément retenu.
+ */
+template<class Range, class RateOf, class Take>
+void fillByFeeRate(const Range& byRateDesc, size_t maxBytes, RateOf rateOf, Take take) {
+    size_t used = 0;
+    size_t misses = 0;
+    for (const auto& element : byRateDesc) {
+        const uint32_t size = rateOf(element).size;
+        if (size > maxBytes - used) {
+            if (++misses >= kMaxSelectionMisses) break;
+            continue;
+        }
+        misses = 0;
+        used += size;
+        take(element);
+    }
+}
+
+/**
+ * Index secondaire de la pool : txids triés par taux de frais décroissant (puis par txid,
+ * ordre total et déterministe). Insertion et suppression en O(log M), les N meilleures
+ * transactions se lisent en O(N) depuis le début. Non synchronisé : protégé par le mutex de la pool.
+ */
+class FeeRateIndex {
+public:
+    struct Entry {
+        FeeRate rate;
+        Hash txid;
+
+        bool operator<(const Entry& other) const {
+            if (rate > other.rate) return true;
+            if (!(rate == other.rate)) return false;
+            return txid < other.txid;
+        }
+    };
+
+private:
+    std::set<Entry> entries_;
+
+public:
+    void insert(const Hash& txid, FeeRate rate) { entries_.insert(Entry{rate, txid}); }
+    /*rate doit être celui donné à insert (conservé par la pool avec la transaction)*/
+    void erase(const Hash& txid, FeeRate rate) { entries_.erase(Entry{rate, txid}); }
+
+    /*Les n txids les mieux payés, du meilleur taux au moins bon*/
+    std::vector<Hash> top(size_t n) const {
+        std::vector<Hash> txids;
+        txids.reserve(std::min(n, entries_.size()));
+        for (auto it = entries_.begin(); it != entries_.end() && txids.size() < n; ++it) {
+            txids.push_back(it->txid);
+        }
+        return txids;
+    }
+
+    /*txids remplissant au mieux maxBytes (voir fillByFeeRate)*/
+    std::vector<Hash> select(size_t maxBytes) const {
+        std::vector<Hash> txids;
+        fillByFeeRate(entries_, maxBytes, [](const Entry& entry) { return entry.rate; },
+                      [&txids](const Entry& entry) { txids.push_back(entry.txid); });
+        return txids;
+    }
+
+    /*visit(txid, rate) du meilleur taux au moins bon*/
+    template<class Visit>
+    void forEach(Visit&& visit) const {
+        for (const auto& entry : entries_) visit(entry.txid, entry.rate);
+    }
+    /*Comme forEach, arrêté dès que visit retourne false*/
+    template<class Visit>
+    void forEachWhile(Visit&& visit) const {
+        for (const auto& entry : entries_) {
+            if (!visit(entry.txid, entry.rate)) break;
+        }
+    }
+
+    /*Entrée au plus faible taux (candidate à l'éviction), nullptr si l'index est vide*/
+    const Entry* lowest() const { return entries_.empty() ? nullptr : &*entries_.rbegin(); }
+
+    size_t size() const { return entries_.size(); }
+    bool empty() const { return entries_.empty(); }
+    void clear() { entries_.clear(); }
+};
+
+#endif // FEE_RATE_INDEX_HPP
@@ -0,0 +1,61 @@
+#ifndef MEMOIZED_HPP
+#define MEMOIZED_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * Valeur calculée une seule fois puis conservée (ex. empreinte d'une transaction).
+ * Sans lock : le premier thread qui termine le calcul publie le résultat, les autres
+ * recalculent au pire une fois en parallèle. La copie ne transfère qu'une valeur déjà prête.
+ * reset() ne doit être appelé que par le propriétaire de l'objet (pendant une modification).
+ */
+template<class T>
+class Memoized {
+    static_assert(std::is_trivially_copyable_v<T>, "Memoized value must be trivially copyable");
+
+private:
+    enum : uint8_t { Empty = 0, Computing = 1, Ready = 2 };
+
+    mutable T value_{};
+    mutable std::atomic<uint8_t> state_{Empty};
+
+public:
+    Memoized() = default;
+    Memoized(const Memoized& other) { copyFrom(other); }
+    Memoized& operator=(const Memoized& other) {
+        if (this != &other) copyFrom(other);
+        return *this;
+    }
+
+    /*Retourne la valeur, calculée par compute() au premier appel*/
+    template<class Compute>
+    T get(Compute&& compute) const {
+        if (state_.load(std::memory_order_acquire) == Ready) {
+            return value_;
+        }
+        const T value = compute();
+        uint8_t expected = Empty;
+        if (state_.compare_exchange_strong(expected, Computing, std::memory_order_acquire)) {
+            value_ = value;
+            state_.store(Ready, std::memory_order_release);
+        }
+        return value;
+    }
+
+    bool isReady() const { return state_.load(std::memory_order_acquire) == Ready; }
+    void reset() { state_.store(Empty, std::memory_order_release); }
+
+private:
+    void copyFrom(const Memoized& other) {
+        if (other.state_.load(std::memory_order_acquire) == Ready) {
+            value_ = other.value_;
+            state_.store(Ready, std::memory_order_release);
+        } else {
+            state_.store(Empty, std::memory_order_release);
+        }
+    }
+};
+
+#endif // MEMOIZED_HPP
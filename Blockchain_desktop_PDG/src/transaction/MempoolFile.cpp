@@ -0,0 +1,73 @@
+#include "transaction/MempoolFile.hpp"
+#include "network/CompactArchive.hpp"
+#include "cryptography/crypto.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+bool MempoolFile::save(const std::string& path, uint32_t height, const Hash& tip, const std::vector<std::shared_ptr<const PoolEntry>>& entries) {
+    std::vector<uint8_t> bytes;
+    try {
+        cereal::CompactOutputArchive ar(bytes);
+        ar(kMagic, kFormatVersion, height, tip);
+        ar(cereal::make_size_tag(static_cast<cereal::size_type>(entries.size())));
+        for (const auto& entry : entries) {
+            ar(entry->tx);
+        }
+    } catch (...) {
+        return false;
+    }
+    Hash checksum;
+    crypto::hashData(bytes, checksum.bytes);
+    bytes.insert(bytes.end(), checksum.bytes.begin(), checksum.bytes.end());
+
+    const std::string tmpPath = path + ".tmp";
+    std::error_code ec;
+    std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    out.close(); // vide le buffer : une erreur d'écriture (disque plein) n'apparaît parfois qu'ici
+    if (!out) {
+        std::filesystem::remove(tmpPath, ec); // l'ancienne sauvegarde reste intacte
+        return false;
+    }
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec) {
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+    return true;
+}
+
+std::optional<MempoolFile::Contents> MempoolFile::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return std::nullopt;
+    }
+    const std::vector<uint8_t> bytes{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    if (bytes.size() < Hash::SIZE) {
+        return std::nullopt;
+    }
+    const std::span<const uint8_t> payload(bytes.data(), bytes.size() - Hash::SIZE);
+    Hash checksum;
+    crypto::hashData(payload, checksum.bytes);
+    if (!std::equal(checksum.bytes.begin(), checksum.bytes.end(), bytes.end() - Hash::SIZE)) {
+        return std::nullopt;
+    }
+
+    try {
+        cereal::CompactInputArchive ar(payload);
+        uint32_t magic = 0;
+        uint8_t version = 0;
+        Contents contents;
+        ar(magic, version);
+        if (magic != kMagic || version != kFormatVersion) {
+            return std::nullopt; // version 1 : sans le hash du dernier bloc, la chaîne de la sauvegarde n'est pas vérifiable
+        }
+        ar(contents.height, contents.tip);
+        ar(contents.txs);
+        return contents;
+    } catch (...) {
+        return std::nullopt;
+    }
+}
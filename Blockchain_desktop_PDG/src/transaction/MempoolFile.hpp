@@ -0,0 +1,34 @@
+#ifndef MEMPOOL_FILE_HPP
+#define MEMPOOL_FILE_HPP
+
+#include "transaction/TransactionPool.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+/**
+ * Sauvegarde de la pool sur disque : en-tête, hauteur et dernier bloc de la chaîne, transactions (parents avant
+ * enfants) dans l'encodage compact du protocole v3, puis SHA-256 de tout ce qui précède.
+ * Relue au démarrage pour ne pas perdre les transactions en attente.
+ */
+class MempoolFile {
+public:
+    struct Contents {
+        uint32_t height = 0;           // nombre de blocs de la chaîne à la sauvegarde
+        Hash tip;                      // hash du bloc height - 1 (nul si la chaîne était vide)
+        std::vector<Transaction> txs;  // parents avant enfants
+    };
+
+    static constexpr uint32_t kMagic = 0x504D4B53; // "SKMP"
+    static constexpr uint8_t kFormatVersion = 2; // 2 : hash du dernier bloc après la hauteur
+
+    /*Écrit un fichier temporaire puis le renomme : un arrêt pendant l'écriture laisse l'ancienne sauvegarde intacte*/
+    static bool save(const std::string& path, uint32_t height, const Hash& tip, const std::vector<std::shared_ptr<const PoolEntry>>& entries);
+    /*nullopt si le fichier est absent, tronqué ou corrompu*/
+    static std::optional<Contents> load(const std::string& path);
+};
+
+#endif // MEMPOOL_FILE_HPP
@@ -0,0 +1,25 @@
+#ifndef OUTPOINT_HPP
+#define OUTPOINT_HPP
+
+#include "cryptography/FixedBytes.hpp"
+
+#include <cstdint>
+#include <functional>
+
+/*Sortie désignée par le txid de sa transaction : même clé qu'elle soit confirmée ou encore dans la pool*/
+struct OutPoint {
+    Hash txid;
+    uint16_t index = 0;
+
+    bool operator==(const OutPoint& other) const { return index == other.index && txid == other.txid; }
+};
+
+namespace std {
+    template<> struct hash<OutPoint> {
+        size_t operator()(const OutPoint& p) const noexcept {
+            return hash<Hash>()(p.txid) ^ (static_cast<size_t>(p.index) * 0x9E3779B97F4A7C15ull);
+        }
+    };
+}
+
+#endif // OUTPOINT_HPP
@@ -3,6 +3,6 @@
 
 const std::string Output::toString() const {
     std::ostringstream oss;
-    oss << "Value: " << value << ", PubKey: " << pubKey;
+    oss << "Value: " << amountToCoins(value) << ", PubKey: " << getPubKey().toHex();
     return oss.str();
 }
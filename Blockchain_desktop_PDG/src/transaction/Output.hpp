@@ -2,31 +2,36 @@
 #define OUTPUT_HPP
 
 #include "cryptography/crypto.hpp"
+#include "transaction/Amount.hpp"
+#include <cereal/cereal.hpp>
 #include <cereal/types/string.hpp>
 
 /*Cette classe représente l'Output de transaction*/
 class Output {
 private:
-    double value{};
-    PubKey pubKey{};
+    Amount value{};
+    PubKey pubKey{}; // pas internée : une sortie reçue d'un pair n'entre dans l'OwnerTable que si un bloc la connecte
 
 public:
     Output() = default; // nécessaire pour la désérialisation
-    Output(double value, const PubKey& pubKey)
+    Output(Amount value, const PubKey& pubKey)
         : value(value), pubKey(pubKey) {}
 
-    const double getValue() const { return value; }
+    Amount getValue() const { return value; }
     const PubKey& getPubKey() const { return pubKey; }
 
     const std::string toString() const;
 
 
+    // Montant en unités de base int64 (version de classe 1 : le mot de version fait partie du format)
     template<class Archive>
-    void serialize(Archive& ar){
+    void serialize(Archive& ar, const std::uint32_t /*version*/) {
         ar(value, pubKey);
     }
 };
 
+CEREAL_CLASS_VERSION(Output, 1);
+
 
 using Outputs = std::vector<Output>; // plus de const pour permettre la (dé)sérialisation
 
@@ -1,6 +1,15 @@
 #include "OutputReference.hpp"
 #include "Blockchain.hpp"
 
+#include <stdexcept>
+
 const Output& OutputReference::getOutput(const Blockchain& blockchain) const {
-    return blockchain[blockIndex][txIndex].getOutputs()[outputIndex];
-}
\ No newline at end of file
+    if (blockIndex >= blockchain.size()) {
+        throw std::out_of_range("Output reference out of range");
+    }
+    const BlockTransactions& txs = blockchain[blockIndex].getBlockTransactions();
+    if (txIndex >= txs.size() || outputIndex >= txs[txIndex].getOutputs().size()) {
+        throw std::out_of_range("Output reference out of range");
+    }
+    return txs[txIndex].getOutputs()[outputIndex];
+}
@@ -2,9 +2,12 @@
 #define OUTPUTREFERENCE_HPP
 
 #include <cstdint>
+#include <limits>
 #include <sstream>
 #include <tuple>
 #include "Output.hpp"
+#include "network/BulkEncoding.hpp"
+#include "network/CompactArchive.hpp"
 
 class Blockchain;
 
@@ -17,9 +20,16 @@ private:
     uint16_t outputIndex;
 
 public:
+    /*Index de bloc réservé : la sortie appartient à une transaction non confirmée, txIndex est alors sa position dans Transaction::parents*/
+    static constexpr uint32_t UNCONFIRMED = std::numeric_limits<uint32_t>::max();
+    /*Index de transaction réservé : unique input d'une récompense de minage, blockIndex est alors la hauteur de son bloc (txids distincts d'un bloc à l'autre)*/
+    static constexpr uint16_t COINBASE = std::numeric_limits<uint16_t>::max();
+
     uint32_t getBlockIndex() const { return blockIndex; }
     uint16_t getTxIndex() const { return txIndex; }
     uint16_t getOutputIndex() const { return outputIndex; }
+    bool isUnconfirmed() const { return blockIndex == UNCONFIRMED; }
+    bool isCoinbase() const { return txIndex == COINBASE && !isUnconfirmed(); }
 
     //Constructor
     OutputReference() : blockIndex(0), txIndex(0), outputIndex(0) {} // pour désérialisation
@@ -33,7 +43,13 @@ public:
     }
 
 
+    bool operator==(const OutputReference& other) const {
+        return blockIndex == other.blockIndex && txIndex == other.txIndex && outputIndex == other.outputIndex;
+    }
+
+
     //Getters
+    /*Sortie confirmée référencée. Lève std::out_of_range si elle n'existe pas (référence venant d'un pair, ou UNCONFIRMED)*/
     const Output& getOutput(const Blockchain& blockchain) const;
 
     //String representation
@@ -43,14 +59,52 @@ public:
         return oss.str();
     }
 
+    // 8 octets sans padding : un seul memcpy (et un seul pour tout un vecteur d'inputs) sur les archives binaires
     template<class Archive>
     void serialize(Archive& ar){
-        ar(blockIndex, txIndex, outputIndex);
+        bulk::record(ar, *this, blockIndex, txIndex, outputIndex);
     }
 
 };
 using Inputs = std::vector<OutputReference>; // retirer const pour serialisation
 
+BULK_ENCODED_VECTOR(OutputReference)
+
+/*Protocole compact : les inputs d'une transaction viennent souvent de blocs proches, l'index de bloc est écrit en delta (zigzag) par rapport à l'input précédent*/
+namespace cereal {
+    template<class A> inline
+    void CEREAL_SAVE_FUNCTION_NAME(CompactOutputArchive& ar, const std::vector<OutputReference, A>& inputs) {
+        ar(make_size_tag(static_cast<size_type>(inputs.size())));
+        int64_t previous = 0;
+        for (const auto& input : inputs) {
+            ar.saveVarint(varint::zigzag(static_cast<int64_t>(input.getBlockIndex()) - previous));
+            ar.saveVarint(input.getTxIndex());
+            ar.saveVarint(input.getOutputIndex());
+            previous = input.getBlockIndex();
+        }
+    }
+
+    template<class A> inline
+    void CEREAL_LOAD_FUNCTION_NAME(CompactInputArchive& ar, std::vector<OutputReference, A>& inputs) {
+        size_type size;
+        ar(make_size_tag(size));
+        inputs.clear();
+        inputs.reserve(static_cast<size_t>(size));
+        int64_t previous = 0;
+        for (size_type i = 0; i < size; ++i) {
+            const int64_t delta = varint::unzigzag(ar.loadVarint());
+            if (delta < -previous || delta > static_cast<int64_t>(std::numeric_limits<uint32_t>::max()) - previous) {
+                throw Exception("Input block index out of range");
+            }
+            const int64_t blockIndex = previous + delta;
+            uint16_t txIndex, outputIndex;
+            ar(txIndex, outputIndex);
+            inputs.emplace_back(static_cast<uint32_t>(blockIndex), txIndex, outputIndex);
+            previous = blockIndex;
+        }
+    }
+}
+
 
 
 #endif // OUTPUTREFERENCE_HPP
\ No newline at end of file
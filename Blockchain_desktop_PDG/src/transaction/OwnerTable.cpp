@@ -0,0 +1,64 @@
+#include "transaction/OwnerTable.hpp"
+
+#include <mutex>
+#include <stdexcept>
+
+OwnerTable::OwnerTable() {
+    intern(PubKey{}); // id 0 : clé nulle, celle d'un Output construit par défaut
+}
+
+OwnerTable::~OwnerTable() {
+    for (auto& segment : segments_) {
+        delete[] segment.load(std::memory_order_relaxed);
+    }
+}
+
+OwnerTable& OwnerTable::instance() {
+    static OwnerTable table;
+    return table;
+}
+
+OwnerId OwnerTable::intern(const PubKey& pubKey) {
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = ids_.find(pubKey);
+        if (it != ids_.end()) return it->second;
+    }
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto it = ids_.find(pubKey); // un autre thread a pu l'insérer entre les deux locks
+    if (it != ids_.end()) return it->second;
+
+    const uint32_t id = size_.load(std::memory_order_relaxed);
+    const uint32_t segmentIndex = id >> kSegmentBits;
+    if (segmentIndex >= kMaxSegments) {
+        throw std::runtime_error("Owner table is full");
+    }
+    PubKey* segment = segments_[segmentIndex].load(std::memory_order_relaxed);
+    if (!segment) {
+        segment = new PubKey[kSegmentSize];
+        segments_[segmentIndex].store(segment, std::memory_order_release);
+    }
+    segment[id & (kSegmentSize - 1)] = pubKey;
+    ids_.emplace(pubKey, id);
+    size_.store(id + 1, std::memory_order_release);
+    return id;
+}
+
+std::optional<OwnerId> OwnerTable::find(const PubKey& pubKey) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = ids_.find(pubKey);
+    if (it == ids_.end()) return std::nullopt;
+    return it->second;
+}
+
+size_t OwnerTable::memoryUsage() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    size_t segments = 0;
+    for (const auto& segment : segments_) {
+        if (segment.load(std::memory_order_relaxed)) ++segments;
+    }
+    // noeud de l'index : paire clé/id + pointeur suivant + hash mis en cache, plus un bucket
+    const size_t nodeBytes = sizeof(std::pair<const PubKey, OwnerId>) + 2 * sizeof(void*);
+    return segments * kSegmentSize * sizeof(PubKey)
+         + ids_.size() * nodeBytes + ids_.bucket_count() * sizeof(void*);
+}
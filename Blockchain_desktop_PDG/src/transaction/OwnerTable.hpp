@@ -0,0 +1,60 @@
+#ifndef OWNER_TABLE_HPP
+#define OWNER_TABLE_HPP
+
+#include "cryptography/crypto.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
+
+/*Identifiant compact d'un propriétaire (clé publique internée). 0 = clé nulle (Output par défaut)*/
+using OwnerId = uint32_t;
+
+/**
+ * Table d'internement des clés publiques : chaque PubKey reçoit un OwnerId dense (32 bits).
+ * UTXOs et WalletIndex ne stockent que l'identifiant. Les entrées ne sont jamais libérées :
+ * seules les sorties connectées par un bloc et les wallets suivis sont internés, une clé
+ * reçue d'un pair (transaction rejetée, orpheline, en attente) n'y est que cherchée (find).
+ *
+ * Les clés sont rangées dans des segments de taille fixe qui ne bougent jamais :
+ * get() ne prend aucun lock et la référence retournée reste valide pour toujours.
+ */
+class OwnerTable {
+private:
+    static constexpr uint32_t kSegmentBits = 16;
+    static constexpr uint32_t kSegmentSize = 1u << kSegmentBits;
+    static constexpr uint32_t kMaxSegments = 1024; // 67 millions de propriétaires
+
+    std::unordered_map<PubKey, OwnerId> ids_;
+    mutable std::shared_mutex mutex_;
+    std::array<std::atomic<PubKey*>, kMaxSegments> segments_{};
+    std::atomic<uint32_t> size_{0};
+
+public:
+    OwnerTable();
+    ~OwnerTable();
+    OwnerTable(const OwnerTable&) = delete;
+    OwnerTable& operator=(const OwnerTable&) = delete;
+
+    /*Table partagée par tout le processus*/
+    static OwnerTable& instance();
+
+    /*Retourne l'identifiant de la clé, en l'ajoutant si elle est inconnue*/
+    OwnerId intern(const PubKey& pubKey);
+    /*Identifiant de la clé si elle a déjà été internée (aucune insertion)*/
+    std::optional<OwnerId> find(const PubKey& pubKey) const;
+
+    /*Clé d'un identifiant retourné par intern() (sans lock)*/
+    const PubKey& get(OwnerId id) const {
+        return segments_[id >> kSegmentBits].load(std::memory_order_acquire)[id & (kSegmentSize - 1)];
+    }
+
+    size_t size() const { return size_.load(std::memory_order_acquire); }
+    /*Mémoire occupée par la table (segments + index), en octets, approximative*/
+    size_t memoryUsage() const;
+};
+
+#endif // OWNER_TABLE_HPP
@@ -1,60 +1,168 @@
 #include "Transaction.hpp"
 #include "Blockchain.hpp"
+#include "cryptography/SignatureCache.hpp"
+#include "cryptography/Sha256.hpp"
+#include "network/ByteArchive.hpp"
 
+#include <algorithm>
+#include <stdexcept>
+#include <string_view>
 
-const double Transaction::getFee(const Blockchain& blockchain) const {
-    double inputSum = 0.0;
-    double outputSum = 0.0;
 
-    for (const auto& input : inputs) {
-        inputSum += input.getOutput(blockchain).getValue();
+SpentOutput Transaction::resolveInput(size_t i, const Blockchain& blockchain, const PendingTxs* pending) const {
+    const OutputReference& input = inputs.at(i);
+    if (input.isCoinbase()) {
+        throw std::out_of_range("Coinbase input");
+    }
+    if (!input.isUnconfirmed()) {
+        const Output& output = input.getOutput(blockchain);
+        const Hash& txid = blockchain[input.getBlockIndex()][input.getTxIndex()].getTxid();
+        return SpentOutput{&output, OutPoint{txid, input.getOutputIndex()}, input};
+    }
+
+    if (input.getTxIndex() >= parents.size()) {
+        throw std::out_of_range("Unknown parent transaction");
+    }
+    const Hash& parentTxid = parents[input.getTxIndex()];
+    const OutPoint outPoint{parentTxid, input.getOutputIndex()};
+    // Parent confirmé depuis la signature : sa position est retrouvée par l'index des txids
+    if (const auto location = blockchain.findTransaction(parentTxid)) {
+        const OutputReference confirmed(location->blockIndex, location->txIndex, input.getOutputIndex());
+        return SpentOutput{&confirmed.getOutput(blockchain), outPoint, confirmed};
+    }
+    if (pending) {
+        auto it = pending->find(parentTxid);
+        if (it != pending->end() && input.getOutputIndex() < it->second->getOutputs().size()) {
+            return SpentOutput{&it->second->getOutputs()[input.getOutputIndex()], outPoint, std::nullopt};
+        }
+    }
+    throw std::out_of_range("Unknown parent transaction");
+}
+
+const Amount Transaction::getFee(const Blockchain& blockchain, const PendingTxs* pending) const {
+    Amount inputSum = 0;
+    Amount outputSum = 0;
+
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        inputSum = checkedAdd(inputSum, resolveInput(i, blockchain, pending).output->getValue());
     }
     for (const auto& output : outputs) {
-        outputSum += output.getValue();
+        outputSum = checkedAdd(outputSum, output.getValue());
     }
     return inputSum - outputSum;
 }
 
-const std::string Transaction::getStrToSign() const {
-        std::ostringstream oss;
-        oss << "Inputs:\n";
-        for (const auto& input : inputs) {
-            oss << "  " << input.toString() << "\n";
+namespace {
+    // Entiers en little-endian, taille fixe : l'encodage ne dépend ni de la plateforme ni d'un formatage texte
+    template<class T>
+    void putLE(sha256::Hasher& hasher, T value) {
+        uint8_t buffer[sizeof(T)];
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            buffer[i] = static_cast<uint8_t>(static_cast<uint64_t>(value) >> (8 * i));
         }
-        oss << "Outputs:\n";
-        for (const auto& output : outputs) {
-            oss << "  " << output.toString() << "\n";
+        hasher.update(buffer);
+    }
+
+    constexpr std::string_view kSigHashTag = "SKBC/sighash/v2";
+    constexpr std::string_view kTxidTag = "SKBC/txid/v1";
+
+    std::span<const uint8_t> tagBytes(std::string_view tag) {
+        return {reinterpret_cast<const uint8_t*>(tag.data()), tag.size()};
+    }
+}
+
+Hash Transaction::computeSigHash() const {
+    // tag | nbInputs u16 | (blockIndex u32, txIndex u16, outputIndex u16)* | [nbParents u16 | txid*] | nbOutputs u16 | (valeur i64, pubKey 33 octets)*
+    // Les parents ne sont présents que si un input est UNCONFIRMED, comme dans l'encodage binaire
+    sha256::Hasher hasher;
+    hasher.update(tagBytes(kSigHashTag));
+    putLE(hasher, static_cast<uint16_t>(inputs.size()));
+    for (const auto& input : inputs) {
+        putLE(hasher, input.getBlockIndex());
+        putLE(hasher, input.getTxIndex());
+        putLE(hasher, input.getOutputIndex());
+    }
+    if (hasUnconfirmedInputs()) {
+        putLE(hasher, static_cast<uint16_t>(parents.size()));
+        for (const auto& parent : parents) {
+            hasher.update(parent.bytes);
         }
-        return oss.str();
     }
+    putLE(hasher, static_cast<uint16_t>(outputs.size()));
+    for (const auto& output : outputs) {
+        putLE(hasher, static_cast<uint64_t>(output.getValue()));
+        hasher.update(output.getPubKey().bytes);
+    }
+    Hash sigHash;
+    hasher.finalize(sigHash.bytes);
+    return sigHash;
+}
 
+Hash Transaction::computeTxid() const {
+    // Le sighash couvre déjà inputs et outputs : seule la signature reste à ajouter
+    sha256::Hasher hasher;
+    hasher.update(tagBytes(kTxidTag));
+    hasher.update(getSigHash().bytes);
+    putLE(hasher, static_cast<uint16_t>(signature.size()));
+    hasher.update(crypto::asBytes(signature));
+    Hash txid;
+    hasher.finalize(txid.bytes);
+    return txid;
+}
 
-const bool Transaction::verifyInputs(const Blockchain& blockchain, const UTXOs& unspentOutputs) const {
-    if (inputs.empty() || inputs.size() >= MAX_INPUTS) {
-        return false;
+uint32_t Transaction::computeSize() const {
+    PooledBuffer bytes;
+    {
+        cereal::ByteOutputArchive ar(bytes.get());
+        ar(*this);
     }
+    return static_cast<uint32_t>(bytes.bytes().size());
+}
+
+void Transaction::sign(EVP_PKEY* privateKey) {
+    const Hash sigHash = getSigHash();
+    uint8_t buffer[crypto::MAX_SIGNATURE_SIZE];
+    const size_t signatureLen = crypto::signData(sigHash.bytes, privateKey, buffer);
+    signature.assign(reinterpret_cast<const char*>(buffer), signatureLen);
+    txid_.reset();
+    size_.reset();
+}
 
-    // PubKey de référence: propriétaire du premier input
-    const PubKey pubKey = inputs[0].getOutput(blockchain).getPubKey();
 
-    // Vérifie que la clé existe dans UTXOs
-    auto it = unspentOutputs.find(pubKey);
-    if (it == unspentOutputs.end()) {
+const bool Transaction::verifyInputs(const Blockchain& blockchain, const UTXOs& unspentOutputs, const PendingTxs* pending) const {
+    if (inputs.empty() || inputs.size() >= MAX_INPUTS || parents.size() > inputs.size()) {
         return false;
     }
-    const auto& ownedUtxos = it->second;
 
-    for (const auto& input : inputs) {
-        const Output& out = input.getOutput(blockchain);
-        if (out.getValue() <= 0) {
+    // Propriétaire de référence: celui du premier input
+    const PubKey& owner = resolveInput(0, blockchain, pending).output->getPubKey();
+
+    // UTXOs confirmées du propriétaire (absentes s'il ne dépense que des sorties non confirmées)
+    const auto ownerId = OwnerTable::instance().find(owner);
+    auto it = ownerId ? unspentOutputs.find(*ownerId) : unspentOutputs.end();
+    const std::set<OutputReference>* ownedUtxos = it != unspentOutputs.end() ? &it->second : nullptr;
+
+    std::vector<OutPoint> spent;
+    spent.reserve(inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        const SpentOutput resolved = resolveInput(i, blockchain, pending);
+        if (resolved.output->getValue() <= 0) {
             return false;
         }
-        if (out.getPubKey() != pubKey) {
+        if (!(resolved.output->getPubKey() == owner)) {
             return false; // tous les inputs doivent appartenir au même owner
         }
-        if (ownedUtxos.find(input) == ownedUtxos.end()) {
+        if (resolved.confirmed && (!ownedUtxos || ownedUtxos->find(*resolved.confirmed) == ownedUtxos->end())) {
             return false; // l’input doit être non dépensé
         }
+        spent.push_back(resolved.outPoint);
+    }
+
+    // Une même sortie ne peut pas être dépensée deux fois par la transaction (positionnellement ou via son parent)
+    for (size_t i = 1; i < spent.size(); ++i) {
+        if (std::find(spent.begin(), spent.begin() + i, spent[i]) != spent.begin() + i) {
+            return false;
+        }
     }
     return true;
 }
@@ -66,53 +174,86 @@ const bool Transaction::verifyOutputs() const {
     }
 
     for (const auto& output : outputs) {
-        if (output.getValue() < 0) {
-            return false; // Output value must be positive
+        if (!isValidAmount(output.getValue())) {
+            return false; // Output value must be in [0, MAX_MONEY]
         }
     }
     return true;
 }
 
-const bool Transaction::verify(const Blockchain& blockchain, const UTXOs& unspentOutputs) const {
-    return verifyInputs(blockchain, unspentOutputs) && verifyOutputs() && verifySold(blockchain) && verifySignature(blockchain);
+const bool Transaction::verify(const Blockchain& blockchain, const UTXOs& unspentOutputs, const PendingTxs* pending) const {
+    return verifyWithoutSignature(blockchain, unspentOutputs, pending) && verifySignature(blockchain, pending);
+}
+
+const bool Transaction::verifyWithoutSignature(const Blockchain& blockchain, const UTXOs& unspentOutputs, const PendingTxs* pending) const {
+    try {
+        return verifyInputs(blockchain, unspentOutputs, pending) && verifyOutputs() && verifySold(blockchain, pending);
+    } catch (...) {
+        return false; // input introuvable
+    }
+}
+
+const bool Transaction::verifySignature(const PubKey& ownerPubKey) const {
+    try {
+        const Hash sigHash = getSigHash();
+        SignatureCache& cache = SignatureCache::instance();
+        if (cache.contains(sigHash, ownerPubKey, signature)) {
+            return true;
+        }
+        if (!crypto::verifySignature(sigHash.bytes, crypto::asBytes(signature), ownerPubKey)) {
+            return false;
+        }
+        cache.insert(sigHash, ownerPubKey, signature);
+        return true;
+    } catch (...) {
+        return false;
+    }
 }
 
 const bool Transaction::verifyMiningReward(const Blockchain& blockchain, const Block& block) const {
-    return outputs.size() == 1 and inputs.empty() and signature.empty() and outputs[0].getValue() == BlockTransactions::calculateMinerReward(blockchain, block);
+    try {
+        return outputs.size() == 1 and isMiningReward() and inputs[0].getBlockIndex() == block.getIndex() and inputs[0].getOutputIndex() == 0
+            and parents.empty() and signature.empty() and outputs[0].getValue() == BlockTransactions::calculateMinerReward(blockchain, block);
+    } catch (...) {
+        return false; // frais du bloc hors de [0, MAX_MONEY]
+    }
 }
 
 const Transaction Transaction::createWithFromPub(EVP_PKEY* fromPrivKey,
                                                  const PubKey& fromPubKey,
                                                  const PubKey& toPubKey,
-                                                 double amount, double fee,
+                                                 Amount amount, Amount fee,
                                                  const Blockchain& blockchain)
 {
-    if (blockchain.getWalletBalance(fromPubKey) < amount + fee) {
+    const auto chain = blockchain.readLock();
+    const Amount required = checkedAdd(amount, fee);
+    if (blockchain.getWalletBalance(fromPubKey) < required) {
         throw std::runtime_error("Insufficient balance");
     }
 
     Inputs inputs;
-    double totalBalance = 0.0;
+    Amount totalBalance = 0;
 
-    const auto allUtxos = blockchain.getUTXOs();
-    auto it = allUtxos.find(fromPubKey);
+    const auto& allUtxos = blockchain.getUTXOs();
+    const auto fromOwner = OwnerTable::instance().find(fromPubKey);
+    auto it = fromOwner ? allUtxos.find(*fromOwner) : allUtxos.end();
     if (it == allUtxos.end() || it->second.empty()) {
         throw std::runtime_error("No UTXOs available for sender");
     }
 
     for (const auto& outRef : it->second) {
         inputs.push_back(outRef);
-        totalBalance += outRef.getOutput(blockchain).getValue();
-        if (totalBalance >= amount + fee) break;
+        totalBalance = checkedAdd(totalBalance, outRef.getOutput(blockchain).getValue());
+        if (totalBalance >= required) break;
     }
 
-    if (totalBalance < amount + fee) {
+    if (totalBalance < required) {
         throw std::runtime_error("Insufficient gathered UTXOs");
     }
 
     Outputs outputs;
     outputs.push_back(Output(amount, toPubKey));
-    const double change = totalBalance - amount - fee;
+    const Amount change = totalBalance - required;
     if (change > 0) {
         outputs.push_back(Output(change, fromPubKey));
     }
@@ -124,11 +265,12 @@ const Transaction Transaction::createWithFromPub(EVP_PKEY* fromPrivKey,
 
 
 std::string Transaction::getTransactionWalletStr(const PubKey& pubKey, const Blockchain& blockchain) const{
-    double amount = 0.0;
+    Amount amount = 0;
 
-    for (const auto& input : inputs) {
-        if (input.getOutput(blockchain).getPubKey() == pubKey) {
-            amount -= input.getOutput(blockchain).getValue();
+    for (size_t i = 0; i < inputs.size() && !isMiningReward(); ++i) {
+        const Output& spent = *resolveInput(i, blockchain).output;
+        if (spent.getPubKey() == pubKey) {
+            amount -= spent.getValue();
         }
     }
 
@@ -139,17 +281,17 @@ std::string Transaction::getTransactionWalletStr(const PubKey& pubKey, const Blo
     }
 
     // Helper lambda pour formater les pubKeys
-    auto formatPubKey = [](const std::string& key) -> std::string {
-        if (key.length() <= 16) return key;
+    auto formatPubKey = [](const PubKey& pubKey) -> std::string {
+        const std::string key = pubKey.toHex();
         return key.substr(0, 8) + "..." + key.substr(key.length() - 8);
     };
 
     if (amount < 0) {
-        return "de " + formatPubKey(pubKey) + "\nà " + formatPubKey(outputs[0].getPubKey()) + "\n" + std::to_string(amount);
+        return "de " + formatPubKey(pubKey) + "\nà " + formatPubKey(outputs[0].getPubKey()) + "\n" + std::to_string(amountToCoins(amount));
     } else {
-        if (inputs.size() > 0) {
-            return "de " + formatPubKey(inputs[0].getOutput(blockchain).getPubKey()) + "\nà " + formatPubKey(pubKey) + "\n" + std::to_string(amount);
+        if (!inputs.empty() && !isMiningReward()) {
+            return "de " + formatPubKey(resolveInput(0, blockchain).output->getPubKey()) + "\nà " + formatPubKey(pubKey) + "\n" + std::to_string(amountToCoins(amount));
         }
-        return "de Mining reward\nà " + formatPubKey(pubKey) + "\n" + std::to_string(amount);
+        return "de Mining reward\nà " + formatPubKey(pubKey) + "\n" + std::to_string(amountToCoins(amount));
     }
 }
\ No newline at end of file
@@ -8,13 +8,16 @@
 #include <string>
 #include <unordered_map>
 #include <set>
+#include <optional>
 
 #include <cereal/types/vector.hpp>
 #include <cereal/types/string.hpp>
 
 #include "cryptography/crypto.hpp"
 #include "OutputReference.hpp"
+#include "transaction/OutPoint.hpp"
 #include "transaction/UTXOs.hpp"
+#include "transaction/Memoized.hpp"
 
 class Blockchain;
 class Block;
@@ -22,6 +25,16 @@ class Block;
 #define MAX_INPUTS 200
 #define MAX_OUTPUTS 20
 
+class Transaction;
+/*Transactions pas encore confirmées (pool, ou début du bloc en cours de vérification) dont les sorties peuvent être dépensées, par txid*/
+using PendingTxs = std::unordered_map<Hash, const Transaction*>;
+
+/*Sortie dépensée par un input, résolue dans la chaîne ou parmi les transactions en attente*/
+struct SpentOutput {
+    const Output* output;
+    OutPoint outPoint;
+    std::optional<OutputReference> confirmed; // position dans la chaîne, absente si le parent n'est pas confirmé
+};
 
 
 /*Cette classe représente une transaction dans la blockchain. Elle contient des entrées (inputs) et des sorties (outputs), ainsi qu'une signature pour vérifier l'authenticité de la transaction.*/
@@ -30,20 +43,36 @@ private:
     Inputs inputs;
     Outputs outputs;
     Signature signature;
+    std::vector<Hash> parents; // transactions non confirmées référencées par les inputs UNCONFIRMED (txIndex = position ici)
+
+    Memoized<Hash> sigHash_; // empreinte des données signées, invalidée si inputs/outputs changent
+    Memoized<Hash> txid_;    // identifiant, invalidé aussi par sign()
+    Memoized<uint32_t> size_; // taille sérialisée, invalidée aussi par sign()
+
+    /*Encodage binaire canonique (inputs puis outputs, taille fixe par élément) haché en une passe*/
+    Hash computeSigHash() const;
+    /*SHA-256 de l'encodage canonique complet : sighash puis signature (préfixée par sa longueur)*/
+    Hash computeTxid() const;
+    uint32_t computeSize() const;
 
     //Verification methods
     /*Vérifie les entrées de la transaction*/
-    const bool verifyInputs(const Blockchain& blockchain, const UTXOs& unspentOutputs) const;
+    const bool verifyInputs(const Blockchain& blockchain, const UTXOs& unspentOutputs, const PendingTxs* pending) const;
     /*Vérifie les sorties de la transaction*/
     const bool verifyOutputs() const;
     /*Vérifie que la transaction est solvable*/
-    const bool verifySold(const Blockchain& blockchain) const {return getFee(blockchain) >= 0;}
+    const bool verifySold(const Blockchain& blockchain, const PendingTxs* pending) const {
+        try {
+            return getFee(blockchain, pending) >= 0;
+        } catch (...) {
+            return false; // somme hors de [0, MAX_MONEY]
+        }
+    }
     /*Vérifie la signature de la transaction*/
-    const bool verifySignature(const Blockchain& blockchain) const {
+    const bool verifySignature(const Blockchain& blockchain, const PendingTxs* pending) const {
         if (inputs.empty()) return false; // rien à vérifier
         try {
-            return crypto::verifySignature(getStrToSign(), signature,
-                                           inputs[0].getOutput(blockchain).getPubKey());
+            return verifySignature(resolveInput(0, blockchain, pending).output->getPubKey());
         } catch (...) {
             return false;
         }
@@ -52,36 +81,52 @@ private:
 public:
     //Constructors
     Transaction() = default; // pour désérialisation
-    Transaction(Inputs inputsIn, Outputs outputsIn)
-        : inputs(std::move(inputsIn)), outputs(std::move(outputsIn)), signature() {}
+    Transaction(Inputs inputsIn, Outputs outputsIn, std::vector<Hash> parentsIn = {})
+        : inputs(std::move(inputsIn)), outputs(std::move(outputsIn)), signature(), parents(std::move(parentsIn)) {}
 
-    /*Crééer une transaction de récompense de minage*/
-    static const Transaction miningReward(const PubKey& minerPubKey, const double reward) {
+    /*Crééer une transaction de récompense de minage pour le bloc à la hauteur donnée (engagée dans le txid par l'input COINBASE)*/
+    static const Transaction miningReward(const PubKey& minerPubKey, const Amount reward, uint32_t height) {
         Output rewardOutput(reward, minerPubKey);
-        return Transaction({}, {rewardOutput});
+        return Transaction({OutputReference(height, OutputReference::COINBASE, 0)}, {rewardOutput});
     }
     /*Créer une transaction signée*/
-    static const Transaction create(EVP_PKEY* fromPrivKey, const PubKey& toPubKey, double amount, double fee, const Blockchain& blockchain);
+    static const Transaction create(EVP_PKEY* fromPrivKey, const PubKey& toPubKey, Amount amount, Amount fee, const Blockchain& blockchain);
 
     // dans class Transaction (en plus de la version existante)
     static const Transaction createWithFromPub(EVP_PKEY* fromPrivKey,
                                                const PubKey& fromPubKey,
                                                const PubKey& toPubKey,
-                                               double amount, double fee,
+                                               Amount amount, Amount fee,
                                                const Blockchain& blockchain);
 
 
-    bool operator<(const Transaction& other) const {
-        return std::tie(inputs, signature) < std::tie(other.inputs, other.signature);
-    }
+    bool operator<(const Transaction& other) const { return getTxid() < other.getTxid(); }
     //Getters
     const Inputs& getInputs() const { return inputs; }
     const Outputs& getOutputs() const { return outputs; }
-    const double getFee(const Blockchain& blockchain) const;
-    const std::string getStrToSign() const;
-    bool isInTransaction(const PubKey& pubKey, const Blockchain& blockchain) const{
+    const Signature& getSignature() const { return signature; }
+    const std::vector<Hash>& getParents() const { return parents; }
+    bool hasUnconfirmedInputs() const {
         for (const auto& input : inputs) {
-            if (input.getOutput(blockchain).getPubKey() == pubKey) {
+            if (input.isUnconfirmed()) return true;
+        }
+        return false;
+    }
+    /*Vrai pour une récompense de minage (unique input COINBASE, qui ne dépense aucune sortie)*/
+    bool isMiningReward() const { return inputs.size() == 1 && inputs[0].isCoinbase(); }
+    /*Sortie dépensée par l'input i : dans la chaîne, sinon parmi pending pour un parent non confirmé. Lève std::out_of_range si introuvable*/
+    SpentOutput resolveInput(size_t i, const Blockchain& blockchain, const PendingTxs* pending = nullptr) const;
+    /*Somme des entrées moins somme des sorties (négative si la transaction dépense trop). Lève std::overflow_error si une somme sort de [0, MAX_MONEY]*/
+    const Amount getFee(const Blockchain& blockchain, const PendingTxs* pending = nullptr) const;
+    /*Empreinte des données signées (calculée au premier appel puis conservée), aussi clé du cache de signatures*/
+    const Hash getSigHash() const { return sigHash_.get([this] { return computeSigHash(); }); }
+    /*Identifiant de la transaction (calculé au premier appel puis conservé) : clé du mempool, de l'index et de l'arbre de Merkle*/
+    const Hash getTxid() const { return txid_.get([this] { return computeTxid(); }); }
+    /*Taille en octets de l'encodage canonique (format réseau v2) : base du taux de frais*/
+    uint32_t getSize() const { return size_.get([this] { return computeSize(); }); }
+    bool isInTransaction(const PubKey& pubKey, const Blockchain& blockchain) const{
+        for (size_t i = 0; i < inputs.size() && !isMiningReward(); ++i) {
+            if (resolveInput(i, blockchain).output->getPubKey() == pubKey) {
                 return true;
             }
         }
@@ -96,17 +141,35 @@ public:
     std::string getTransactionWalletStr(const PubKey& pubKey, const Blockchain& blockchain) const;
 
     //Signature methods
-    void sign(EVP_PKEY* privateKey) {signature = crypto::signData(this->getStrToSign(), privateKey);}
-
-    /*Vérifie la validité de la transaction et ne valide pas une récompense de minage*/
-    const bool verify(const Blockchain& blockchain, const UTXOs& unspentOutputs) const;
+    /*Signe l'empreinte binaire getSigHash()*/
+    void sign(EVP_PKEY* privateKey);
+
+    /*Vérifie la validité de la transaction et ne valide pas une récompense de minage.
+    pending : parents non confirmés autorisés (leurs sorties ne sont pas dans unspentOutputs, l'appelant contrôle qu'elles ne sont pas déjà dépensées)*/
+    const bool verify(const Blockchain& blockchain, const UTXOs& unspentOutputs, const PendingTxs* pending = nullptr) const;
+    /*Vérifie tout sauf la signature (entrées, sorties, solvabilité) : partie qui dépend de l'état de la chaîne*/
+    const bool verifyWithoutSignature(const Blockchain& blockchain, const UTXOs& unspentOutputs, const PendingTxs* pending = nullptr) const;
+    /*Vérifie la signature avec la clé du propriétaire des entrées, déjà résolue par l'appelant (sans accès à la chaîne).
+    Consulte d'abord le SignatureCache : une signature déjà vérifiée (mempool) n'est pas revérifiée*/
+    const bool verifySignature(const PubKey& ownerPubKey) const;
     /*Vérifie une récompense de minage*/
     const bool verifyMiningReward(const Blockchain& blockchain, const Block& block) const;
 
     template<class Archive>
     void serialize(Archive& ar){
-        // signature après inputs/outputs
-        ar(inputs, outputs, signature);
+        // signature après inputs/outputs ; parents seulement si un input les référence (encodage inchangé sinon)
+        ar(inputs);
+        if (hasUnconfirmedInputs()) {
+            ar(parents);
+        } else if constexpr (Archive::is_loading::value) {
+            parents.clear();
+        }
+        ar(outputs, signature);
+        if constexpr (Archive::is_loading::value) {
+            sigHash_.reset();
+            txid_.reset();
+            size_.reset();
+        }
     }
 };
 
@@ -1,39 +1,46 @@
 #include "TransactionPool.hpp"
 #include "Blockchain.hpp"
+#include "cryptography/VerificationPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 
 const Transaction Transaction::create(EVP_PKEY* fromPrivKey, const PubKey& toPubKey,
-                                      double amount, double fee, const Blockchain& blockchain)
+                                      Amount amount, Amount fee, const Blockchain& blockchain)
 {
     const PubKey fromPubKey = crypto::getPubKey(fromPrivKey);
+    const auto chain = blockchain.readLock();
 
-    if (blockchain.getWalletBalance(fromPubKey) < amount + fee) {
+    const Amount required = checkedAdd(amount, fee);
+    if (blockchain.getWalletBalance(fromPubKey) < required) {
         throw std::runtime_error("Insufficient balance");
     }
 
     Inputs inputs;
-    double totalBalance = 0.0;
+    Amount totalBalance = 0;
 
     // Utiliser find() plutôt que at()
-    const auto allUtxos = blockchain.getUTXOs();
-    auto it = allUtxos.find(fromPubKey);
+    const auto& allUtxos = blockchain.getUTXOs();
+    const auto fromOwner = OwnerTable::instance().find(fromPubKey);
+    auto it = fromOwner ? allUtxos.find(*fromOwner) : allUtxos.end();
     if (it == allUtxos.end() || it->second.empty()) {
         throw std::runtime_error("No UTXOs available for sender");
     }
 
     for (const auto& outRef : it->second) {
         inputs.push_back(outRef);
-        totalBalance += outRef.getOutput(blockchain).getValue();
-        if (totalBalance >= amount + fee) break;
+        totalBalance = checkedAdd(totalBalance, outRef.getOutput(blockchain).getValue());
+        if (totalBalance >= required) break;
     }
 
-    if (totalBalance < amount + fee) {
+    if (totalBalance < required) {
         throw std::runtime_error("Insufficient gathered UTXOs");
     }
 
     Outputs outputs;
     outputs.push_back(Output(amount, toPubKey));
-    double change = totalBalance - amount - fee;
+    Amount change = totalBalance - required;
     if (change > 0) {
         outputs.push_back(Output(change, fromPubKey));
     }
@@ -46,36 +53,569 @@ const Transaction Transaction::create(EVP_PKEY* fromPrivKey, const PubKey& toPub
 
 
 bool TransactionPool::addTransaction(const Transaction& tx){
+    const Hash txid = tx.getTxid();
+    // Parents non confirmés : pris dans la pool sous lock, la vérification se fait ensuite sans lock
+    PendingTxs pending;
+    std::vector<std::shared_ptr<const PoolEntry>> held;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // Doublon (même transaction reçue de plusieurs pairs) : rejeté avant toute vérification
+        if (transactions_.count(txid) > 0) {
+            return false;
+        }
+        collectParents_NoLock(tx, pending, held);
+    }
+    FeeRate rate;
     try {
-        auto utxoSnap = blockchain_.getUTXOs();
-        if (!tx.verify(blockchain_, utxoSnap)) {
+        rate = FeeRate{tx.getFee(blockchain_, &pending), tx.getSize()};
+        // Pool sous pression : les transactions sous le taux minimum sont refusées avant la vérification de signature
+        std::lock_guard<std::mutex> lock(mutex_);
+        const double minFeePerKB = currentMinFeePerKB_NoLock();
+        if (minFeePerKB > 0.0 && static_cast<double>(rate.fee) * 1000.0 < minFeePerKB * rate.size) {
+            ++rejectedLowFee_;
             return false;
         }
+    } catch (...) {
+        return false;
+    }
+    std::vector<OutPoint> spends;
+    try {
+        // Lu sur place : l'appelant tient Blockchain::readLock(), aucun bloc ne modifie les UTXOs pendant la vérification
+        if (!tx.verify(blockchain_, blockchain_.getUTXOs(), &pending)) {
+            return false;
+        }
+        spends.reserve(tx.getInputs().size());
+        for (size_t i = 0; i < tx.getInputs().size(); ++i) {
+            spends.push_back(tx.resolveInput(i, blockchain_, &pending).outPoint);
+        }
     } catch (...) {
         return false; // jamais de crash : on refuse simplement
     }
 
     std::lock_guard<std::mutex> lock(mutex_);
 
-    for (const auto& input : tx.getInputs()) {
-        if (spentOutputs_.count(input) > 0) {
+    if (transactions_.count(txid) > 0) {
+        return false; // ajoutée par un autre thread pendant la vérification
+    }
+    // Les parents utilisés pour la vérification doivent toujours être là (ni confirmés ni évincés entre-temps)
+    std::vector<Hash> parents;
+    for (const auto& entry : held) {
+        if (transactions_.count(entry->tx.getTxid()) == 0) {
             return false;
         }
-        spentOutputs_.insert(input);
+        parents.push_back(entry->tx.getTxid());
     }
-    transactions_.insert(tx);
-    return true;
+    // Tous les inputs sont contrôlés avant d'en marquer un seul comme dépensé
+    for (const auto& outPoint : spends) {
+        if (spentOutputs_.count(outPoint) > 0) {
+            return false;
+        }
+    }
+
+    // Package : la transaction et ses ancêtres, dont aucun ne doit dépasser la limite de descendants
+    const std::vector<Hash> ancestors = collectRelatives_NoLock(parents, &Node::parents, kMaxAncestors - 1);
+    FeeRate package = rate;
+    bool withinLimits = ancestors.size() < kMaxAncestors;
+    try {
+        for (const auto& ancestor : ancestors) {
+            const Node& node = transactions_.at(ancestor);
+            package.fee = checkedAdd(package.fee, node.entry->rate.fee);
+            package.size += node.entry->rate.size;
+            checkedAdd(node.descendants.fee, rate.fee);
+            withinLimits = withinLimits && node.descendantCount < kMaxDescendants
+                           && node.descendants.size + rate.size <= kMaxPackageBytes;
+        }
+    } catch (...) {
+        withinLimits = false;
+    }
+    if (!withinLimits || package.size > kMaxPackageBytes) {
+        ++rejectedPackage_;
+        return false;
+    }
+
+    Node node;
+    node.entry = std::make_shared<const PoolEntry>(PoolEntry{tx, rate, entryMemory(tx)});
+    node.spends = std::move(spends);
+    node.parents = std::move(parents);
+    node.package = package;
+    node.ancestorCount = static_cast<uint32_t>(ancestors.size() + 1);
+    node.descendants = rate;
+    node.score = rate;
+    for (const auto& outPoint : node.spends) {
+        spentOutputs_.emplace(outPoint, txid);
+    }
+    for (const auto& parent : node.parents) {
+        transactions_.at(parent).children.push_back(txid);
+    }
+    for (const auto& ancestor : ancestors) {
+        Node& relative = transactions_.at(ancestor);
+        ++relative.descendantCount;
+        relative.descendants.fee += rate.fee;
+        relative.descendants.size += rate.size;
+        rescore_NoLock(ancestor, relative);
+    }
+    if (!node.parents.empty()) {
+        ++chained_;
+    }
+    byFeeRate_.insert(txid, package);
+    byDescendantScore_.insert(txid, node.score);
+    memoryUsage_ += node.entry->memory;
+    transactions_.emplace(txid, std::move(node));
+    version_.fetch_add(1, std::memory_order_release);
+
+    // Modèle de bloc : elle y entre si elle tient, sinon il n'est refait que si elle paye mieux que lui
+    if (!template_.stale) {
+        if (appendToTemplate_NoLock(txid)) {
+            templateVersion_.fetch_add(1, std::memory_order_release);
+        } else if (package > template_.floor) {
+            template_.stale = true;
+            templateVersion_.fetch_add(1, std::memory_order_release);
+        }
+    }
+
+    trimToLimit_NoLock();
+    return transactions_.count(txid) > 0; // évincée aussitôt si c'était la moins bien payée
+}
+
+size_t TransactionPool::restore(const std::vector<Transaction>& txs) {
+    // Les parents non confirmés sont dans le même lot : ils servent à retrouver la clé de chaque enfant
+    PendingTxs saved;
+    saved.reserve(txs.size());
+    for (const auto& tx : txs) {
+        saved.emplace(tx.getTxid(), &tx);
+    }
+    VerificationPool::instance().run(txs.size(), [this, &txs, &saved](size_t i) {
+        try {
+            txs[i].verifySignature(txs[i].resolveInput(0, blockchain_, &saved).output->getPubKey());
+        } catch (...) {
+            // entrée déjà dépensée ou inconnue : refusée par addTransaction
+        }
+        return true; // un échec ne doit pas interrompre le reste du lot
+    });
+
+    size_t restored = 0;
+    for (const auto& tx : txs) {
+        restored += addTransaction(tx) ? 1 : 0;
+    }
+    return restored;
 }
 
 bool TransactionPool::removeTransaction(const Transaction& tx){
     std::lock_guard<std::mutex> lock(mutex_);
     // Vérifie que la transaction existe dans la pool
-    if (transactions_.erase(tx) > 0) {
-        // Supprime les sorties dépensées
-        for (const auto& input : tx.getInputs()) {
-            spentOutputs_.erase(input);
+    auto it = transactions_.find(tx.getTxid());
+    if (it == transactions_.end()) {
+        return false;
+    }
+    removeEntry_NoLock(it);
+    return true;
+}
+
+size_t TransactionPool::removeConflicts(const std::vector<OutPoint>& spent) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t removed = 0;
+    for (const auto& outPoint : spent) {
+        auto spender = spentOutputs_.find(outPoint);
+        if (spender != spentOutputs_.end()) {
+            removed += removeWithDescendants_NoLock(transactions_.find(spender->second));
+        }
+    }
+    conflicts_ += removed;
+    return removed;
+}
+
+std::optional<Output> TransactionPool::findSpentOutput(const Transaction& tx, size_t input) const {
+    PendingTxs pending;
+    std::vector<std::shared_ptr<const PoolEntry>> held;
+    if (input < tx.getInputs().size() && tx.getInputs()[input].isUnconfirmed()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        collectParents_NoLock(tx, pending, held);
+    }
+    try {
+        return *tx.resolveInput(input, blockchain_, &pending).output;
+    } catch (...) {
+        return std::nullopt;
+    }
+}
+
+bool TransactionPool::hasMissingParents(const Transaction& tx) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& input : tx.getInputs()) {
+        if (!input.isUnconfirmed() || input.getTxIndex() >= tx.getParents().size()) {
+            continue;
+        }
+        const Hash& parent = tx.getParents()[input.getTxIndex()];
+        if (transactions_.count(parent) == 0 && !blockchain_.findTransaction(parent)) {
+            return true;
         }
-        return true;
     }
     return false;
+}
+
+void TransactionPool::collectParents_NoLock(const Transaction& tx, PendingTxs& pending,
+                                            std::vector<std::shared_ptr<const PoolEntry>>& held) const {
+    for (const auto& parent : tx.getParents()) {
+        auto it = transactions_.find(parent);
+        if (it != transactions_.end() && pending.emplace(parent, &it->second.entry->tx).second) {
+            held.push_back(it->second.entry);
+        }
+    }
+}
+
+std::vector<Hash> TransactionPool::collectRelatives_NoLock(const std::vector<Hash>& start, std::vector<Hash> Node::* next, size_t limit) const {
+    // Parcours borné : les limites de package gardent ces ensembles petits (quelques dizaines d'entrées)
+    std::vector<Hash> found;
+    std::vector<Hash> toVisit(start);
+    while (!toVisit.empty() && found.size() <= limit) {
+        const Hash txid = toVisit.back();
+        toVisit.pop_back();
+        if (std::find(found.begin(), found.end(), txid) != found.end()) {
+            continue;
+        }
+        found.push_back(txid);
+        const auto& relatives = transactions_.at(txid).*next;
+        toVisit.insert(toVisit.end(), relatives.begin(), relatives.end());
+    }
+    return found;
+}
+
+void TransactionPool::rescore_NoLock(const Hash& txid, Node& node) {
+    // Une transaction peu payée reste si ses descendants paient pour elle (CPFP), jamais moins que son propre taux
+    const FeeRate score = node.descendants > node.entry->rate ? node.descendants : node.entry->rate;
+    if (score == node.score) {
+        return;
+    }
+    byDescendantScore_.erase(txid, node.score);
+    node.score = score;
+    byDescendantScore_.insert(txid, node.score);
+}
+
+void TransactionPool::removeEntry_NoLock(NodeMap::iterator it) {
+    const Hash txid = it->first;
+    const Node& node = it->second;
+    const FeeRate rate = node.entry->rate;
+    constexpr size_t kAll = std::numeric_limits<size_t>::max();
+
+    // Les descendants perdent un ancêtre : leur package (et donc leur place dans byFeeRate_) change
+    for (const auto& descendant : collectRelatives_NoLock(node.children, &Node::children, kAll)) {
+        Node& relative = transactions_.at(descendant);
+        byFeeRate_.erase(descendant, relative.package);
+        relative.package.fee -= rate.fee;
+        relative.package.size -= rate.size;
+        --relative.ancestorCount;
+        byFeeRate_.insert(descendant, relative.package);
+    }
+    for (const auto& ancestor : collectRelatives_NoLock(node.parents, &Node::parents, kAll)) {
+        Node& relative = transactions_.at(ancestor);
+        --relative.descendantCount;
+        relative.descendants.fee -= rate.fee;
+        relative.descendants.size -= rate.size;
+        rescore_NoLock(ancestor, relative);
+    }
+    for (const auto& child : node.children) {
+        auto& parents = transactions_.at(child).parents;
+        std::erase(parents, txid);
+        if (parents.empty()) {
+            --chained_;
+        }
+    }
+    for (const auto& parent : node.parents) {
+        std::erase(transactions_.at(parent).children, txid);
+    }
+    if (!node.parents.empty()) {
+        --chained_;
+    }
+
+    // Supprime les sorties dépensées
+    for (const auto& outPoint : node.spends) {
+        spentOutputs_.erase(outPoint);
+    }
+    auto position = template_.positions.find(txid);
+    if (position != template_.positions.end()) {
+        template_.positions.erase(position); // sa case dans order est ignorée puis compactée à la publication
+        template_.bytes -= rate.size;
+        template_.fees -= rate.fee;
+        template_.room = true;
+        templateVersion_.fetch_add(1, std::memory_order_release);
+    }
+    byFeeRate_.erase(txid, node.package);
+    byDescendantScore_.erase(txid, node.score);
+    memoryUsage_ -= node.entry->memory;
+    transactions_.erase(it);
+    version_.fetch_add(1, std::memory_order_release);
+}
+
+size_t TransactionPool::removeWithDescendants_NoLock(NodeMap::iterator it) {
+    std::vector<Hash> descendants = collectRelatives_NoLock(it->second.children, &Node::children, std::numeric_limits<size_t>::max());
+    // Les plus profonds d'abord (plus d'ancêtres) : chaque entrée retirée n'a plus de descendant dans la pool
+    std::sort(descendants.begin(), descendants.end(), [this](const Hash& a, const Hash& b) {
+        return transactions_.at(a).ancestorCount > transactions_.at(b).ancestorCount;
+    });
+    for (const auto& descendant : descendants) {
+        removeEntry_NoLock(transactions_.find(descendant));
+    }
+    removeEntry_NoLock(it);
+    return descendants.size() + 1;
+}
+
+bool TransactionPool::appendToTemplate_NoLock(const Hash& txid) const {
+    // Le modèle contient toujours les ancêtres de ses transactions : seuls ceux qui n'y sont pas encore sont ajoutés
+    std::vector<Hash> package = collectRelatives_NoLock({txid}, &Node::parents, std::numeric_limits<size_t>::max());
+    std::erase_if(package, [this](const Hash& h) { return template_.positions.count(h) > 0; });
+    size_t bytes = 0;
+    for (const auto& h : package) {
+        bytes += transactions_.at(h).entry->rate.size;
+    }
+    if (bytes > template_.maxBytes - template_.bytes) {
+        return false;
+    }
+    // Moins d'ancêtres d'abord : chaque parent précède ses enfants
+    std::sort(package.begin(), package.end(), [this](const Hash& a, const Hash& b) {
+        return transactions_.at(a).ancestorCount < transactions_.at(b).ancestorCount;
+    });
+    const FeeRate rate = transactions_.at(txid).package;
+    if (template_.positions.empty() || template_.floor > rate) {
+        template_.floor = rate;
+    }
+    for (const auto& h : package) {
+        const PoolEntry& entry = *transactions_.at(h).entry;
+        template_.positions.emplace(h, static_cast<uint32_t>(template_.order.size()));
+        template_.order.push_back(h);
+        template_.bytes += entry.rate.size;
+        template_.fees += entry.rate.fee;
+    }
+    return true;
+}
+
+void TransactionPool::fillTemplate_NoLock() const {
+    size_t misses = 0;
+    byFeeRate_.forEachWhile([this, &misses](const Hash& txid, const FeeRate&) {
+        if (template_.positions.count(txid) > 0) {
+            return true;
+        }
+        if (appendToTemplate_NoLock(txid)) {
+            misses = 0;
+            return true;
+        }
+        return ++misses < kMaxSelectionMisses;
+    });
+}
+
+size_t TransactionPool::entryMemory(const Transaction& tx) {
+    constexpr size_t kTreeNode = 4 * sizeof(void*); // couleur, parent et deux enfants (std::set)
+    constexpr size_t kHashNode = 3 * sizeof(void*); // suivant, hash en cache et case du tableau (std::unordered_map)
+    size_t bytes = 2 * sizeof(void*) + sizeof(PoolEntry); // bloc make_shared : compteurs et entrée
+    bytes += tx.getInputs().capacity() * sizeof(OutputReference) + tx.getOutputs().capacity() * sizeof(Output);
+    bytes += tx.getParents().capacity() * sizeof(Hash);
+    if (tx.getSignature().capacity() > 15) {
+        bytes += tx.getSignature().capacity() + 1; // hors du buffer interne de std::string
+    }
+    bytes += kHashNode + sizeof(std::pair<const Hash, Node>);                          // transactions_
+    bytes += 2 * (kTreeNode + sizeof(FeeRateIndex::Entry));                             // byFeeRate_ et byDescendantScore_
+    bytes += tx.getInputs().size() * (sizeof(OutPoint) + kHashNode + sizeof(std::pair<const OutPoint, Hash>)); // spends et spentOutputs_
+    bytes += tx.getParents().size() * 2 * sizeof(Hash);                                 // liens parent/enfant du graphe
+    bytes += sizeof(std::shared_ptr<const PoolEntry>);                                  // place dans un snapshot
+    bytes += kHashNode + sizeof(std::pair<const Hash, uint32_t>) + sizeof(Hash);       // place dans le modèle de bloc
+    return bytes;
+}
+
+double TransactionPool::currentMinFeePerKB_NoLock() const {
+    if (minFeePerKB_ <= 0.0) {
+        return 0.0;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    double halfLife = std::chrono::duration<double>(kMinFeeHalfLife).count();
+    if (memoryUsage_ < maxMemory_ / 4) {
+        halfLife /= 4; // la pression est retombée
+    } else if (memoryUsage_ < maxMemory_ / 2) {
+        halfLife /= 2;
+    }
+    const double elapsed = std::chrono::duration<double>(now - minFeeUpdated_).count();
+    minFeePerKB_ *= std::exp2(-elapsed / halfLife);
+    minFeeUpdated_ = now;
+    if (minFeePerKB_ < kMinFeeIncrementPerKB / 2) {
+        minFeePerKB_ = 0.0;
+    }
+    return minFeePerKB_;
+}
+
+void TransactionPool::trimToLimit_NoLock() {
+    while (memoryUsage_ > maxMemory_) {
+        const FeeRateIndex::Entry* lowest = byDescendantScore_.lowest();
+        if (!lowest) {
+            break;
+        }
+        const double evictedPerKB = static_cast<double>(lowest->rate.fee) * 1000.0 / lowest->rate.size;
+        minFeePerKB_ = std::max(currentMinFeePerKB_NoLock(), evictedPerKB + kMinFeeIncrementPerKB);
+        minFeeUpdated_ = std::chrono::steady_clock::now();
+        // Ses descendants ne peuvent pas rester sans elle
+        evicted_ += removeWithDescendants_NoLock(transactions_.find(lowest->txid));
+    }
+}
+
+void TransactionPool::setMaxMemory(size_t maxMemory) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    maxMemory_ = maxMemory;
+    trimToLimit_NoLock();
+}
+
+TransactionPool::Stats TransactionPool::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats s;
+    s.count = transactions_.size();
+    s.memoryUsage = memoryUsage_;
+    s.maxMemory = maxMemory_;
+    s.evicted = evicted_;
+    s.rejectedLowFee = rejectedLowFee_;
+    s.rejectedPackage = rejectedPackage_;
+    s.conflicts = conflicts_;
+    s.chained = chained_;
+    s.templateRebuilds = template_.rebuilds;
+    s.minFeePerKB = currentMinFeePerKB_NoLock();
+    return s;
+}
+
+std::shared_ptr<const PoolSnapshot> TransactionPool::snapshot() const {
+    auto current = published_.load(std::memory_order_acquire);
+    if (current && current->version == version_.load(std::memory_order_acquire)) {
+        return current;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Un autre lecteur a pu reconstruire la vue pendant l'attente du lock
+    current = published_.load(std::memory_order_acquire);
+    const uint64_t version = version_.load(std::memory_order_acquire);
+    if (current && current->version == version) {
+        return current;
+    }
+    auto fresh = std::make_shared<PoolSnapshot>();
+    fresh->version = version;
+    fresh->byFeeRate.reserve(transactions_.size());
+    std::vector<const Node*> nodes;
+    nodes.reserve(transactions_.size());
+    byFeeRate_.forEach([this, &fresh, &nodes](const Hash& txid, const FeeRate&) {
+        const Node& node = transactions_.at(txid);
+        nodes.push_back(&node);
+        fresh->byFeeRate.push_back(node.entry);
+        fresh->bytes += node.entry->rate.size;
+    });
+    // Liens de parenté traduits en positions, seulement si des transactions sont chaînées
+    if (chained_ > 0) {
+        std::unordered_map<Hash, uint32_t> positions;
+        positions.reserve(nodes.size());
+        for (uint32_t i = 0; i < nodes.size(); ++i) {
+            positions.emplace(fresh->byFeeRate[i]->tx.getTxid(), i);
+        }
+        fresh->parents.resize(nodes.size());
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            for (const auto& parent : nodes[i]->parents) {
+                fresh->parents[i].push_back(positions.at(parent));
+            }
+        }
+    }
+    published_.store(fresh, std::memory_order_release);
+    return fresh;
+}
+
+std::shared_ptr<const BlockTemplate> TransactionPool::blockTemplate() const {
+    auto current = publishedTemplate_.load(std::memory_order_acquire);
+    if (current && current->version == templateVersion_.load(std::memory_order_acquire)) {
+        return current;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    current = publishedTemplate_.load(std::memory_order_acquire);
+    const uint64_t version = templateVersion_.load(std::memory_order_acquire);
+    if (current && current->version == version) {
+        return current;
+    }
+    if (template_.stale) {
+        template_.positions.clear();
+        template_.order.clear();
+        template_.bytes = 0;
+        template_.fees = 0;
+        ++template_.rebuilds;
+    }
+    if (template_.stale || template_.room) {
+        fillTemplate_NoLock();
+        template_.stale = false;
+        template_.room = false;
+    }
+
+    auto fresh = std::make_shared<BlockTemplate>();
+    fresh->version = version;
+    fresh->fees = template_.fees;
+    fresh->bytes = template_.bytes;
+    fresh->entries.reserve(template_.positions.size());
+    // Compacte order en sautant les cases des transactions retirées
+    auto& order = template_.order;
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < order.size(); ++i) {
+        auto position = template_.positions.find(order[i]);
+        if (position == template_.positions.end() || position->second != i) {
+            continue;
+        }
+        position->second = kept;
+        order[kept++] = order[i];
+        fresh->entries.push_back(transactions_.at(order[i]).entry);
+    }
+    order.resize(kept);
+    publishedTemplate_.store(fresh, std::memory_order_release);
+    return fresh;
+}
+
+void TransactionPool::setTemplateBytes(size_t maxBytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    template_.maxBytes = maxBytes;
+    template_.stale = true;
+    templateVersion_.fetch_add(1, std::memory_order_release);
+}
+
+std::vector<std::shared_ptr<const PoolEntry>> TransactionPool::selectForBlock(size_t maxBytes) const {
+    const auto view = snapshot();
+    std::vector<std::shared_ptr<const PoolEntry>> entries;
+    if (view->parents.empty()) {
+        fillByFeeRate(view->byFeeRate, maxBytes, [](const auto& entry) { return entry->rate; },
+                      [&entries](const auto& entry) { entries.push_back(entry); });
+        return entries;
+    }
+
+    // Même glouton par package : une transaction est prise avec ses ancêtres pas encore retenus, parents d'abord
+    const uint32_t count = static_cast<uint32_t>(view->byFeeRate.size());
+    std::vector<uint8_t> taken(count, 0);
+    std::vector<uint32_t> visited(count, std::numeric_limits<uint32_t>::max());
+    std::vector<uint32_t> package;
+    size_t used = 0;
+    size_t misses = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (taken[i]) {
+            continue;
+        }
+        package.clear();
+        size_t bytes = 0;
+        // Parcours en profondeur (au plus kMaxAncestors niveaux) : chaque ancêtre est ajouté après ses propres parents
+        auto visit = [&](auto&& self, uint32_t k) -> void {
+            if (taken[k] || visited[k] == i) {
+                return;
+            }
+            visited[k] = i;
+            for (uint32_t parent : view->parents[k]) {
+                self(self, parent);
+            }
+            package.push_back(k);
+            bytes += view->byFeeRate[k]->rate.size;
+        };
+        visit(visit, i);
+        if (bytes > maxBytes - used) {
+            if (++misses >= kMaxSelectionMisses) break;
+            continue;
+        }
+        misses = 0;
+        used += bytes;
+        for (uint32_t k : package) {
+            taken[k] = 1;
+            entries.push_back(view->byFeeRate[k]);
+        }
+    }
+    return entries;
 }
\ No newline at end of file
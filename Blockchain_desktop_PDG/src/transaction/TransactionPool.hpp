@@ -2,29 +2,199 @@
 #define TRANSACTION_POOL_HPP
 
 #include "Transaction.hpp"
+#include "transaction/FeeRateIndex.hpp"
+#include "config.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
 #include <set>
+#include <unordered_map>
+#include <vector>
+
+/*Transaction en attente avec son taux de frais, calculé une fois à l'admission*/
+struct PoolEntry {
+    Transaction tx;
+    FeeRate rate;   // frais (unités de base) et taille sérialisée (octets)
+    size_t memory;  // octets occupés dans la pool (entrée et noeuds des index)
+};
+
+/**
+ * Vue figée de la pool à une version donnée. Immuable une fois publiée : le mineur et l'UI la
+ * parcourent sans lock pendant que la pool continue d'admettre des transactions. Les entrées
+ * sont partagées (shared_ptr) avec la pool ; une vue est libérée quand son dernier lecteur la lâche.
+ */
+struct PoolSnapshot {
+    uint64_t version = 0;
+    std::vector<std::shared_ptr<const PoolEntry>> byFeeRate; // taux de frais du package (avec ancêtres) décroissant
+    std::vector<std::vector<uint32_t>> parents;               // positions dans byFeeRate des parents dans la pool (vide si aucune transaction chaînée)
+    size_t bytes = 0;                                         // somme des tailles sérialisées
+};
+
+/*Contenu de bloc préparé par la pool : transactions retenues (parents d'abord), frais et taille déjà sommés*/
+struct BlockTemplate {
+    uint64_t version = 0;
+    std::vector<std::shared_ptr<const PoolEntry>> entries;
+    Amount fees = 0;
+    size_t bytes = 0;
+};
 
 /**
  * Classe représentant le pool de transactions en attente.
  * Elle assure la gestion des transactions en attente et leur validation.
  */
 class TransactionPool {
+public:
+    struct Stats {
+        size_t count = 0;
+        size_t memoryUsage = 0;
+        size_t maxMemory = 0;
+        uint64_t evicted = 0;         // retirées pour respecter maxMemory
+        uint64_t rejectedLowFee = 0;  // refusées sous le taux minimum
+        uint64_t rejectedPackage = 0; // chaîne au-delà des limites d'ancêtres ou de descendants
+        uint64_t conflicts = 0;       // retirées car un bloc dépense les mêmes sorties (descendants compris)
+        size_t chained = 0;           // ayant un parent dans la pool
+        uint64_t templateRebuilds = 0; // modèle de bloc refait depuis le début
+        double minFeePerKB = 0.0;     // taux minimum courant (unités de base par 1000 octets)
+    };
+
+    // Le taux minimum dépasse d'au moins ce pas celui de la dernière évincée, puis décroît de moitié toutes les kMinFeeHalfLife
+    static constexpr double kMinFeeIncrementPerKB = 1000.0;
+    static constexpr std::chrono::seconds kMinFeeHalfLife{3600};
+
+    // Chaînes de transactions non confirmées : une transaction et ses ancêtres (ou descendants) dans la pool
+    // restent sous ces limites, ce qui borne le coût de l'admission et de la suppression
+    static constexpr uint32_t kMaxAncestors = 25;
+    static constexpr uint32_t kMaxDescendants = 25;
+    static constexpr uint32_t kMaxPackageBytes = 40000;
+    static_assert(MAX_MONEY <= INT64_MAX / kMaxPackageBytes, "FeeRate comparisons of a package must not overflow");
+
 private:
+    /*Entrée et sa place dans le graphe des transactions non confirmées*/
+    struct Node {
+        std::shared_ptr<const PoolEntry> entry;
+        std::vector<OutPoint> spends;   // sorties dépensées (clés de spentOutputs_)
+        std::vector<Hash> parents;      // parents encore dans la pool
+        std::vector<Hash> children;
+        FeeRate package;                // la transaction et tous ses ancêtres dans la pool : clé de byFeeRate_
+        uint32_t ancestorCount = 1;     // elle comprise
+        uint32_t descendantCount = 1;
+        FeeRate descendants;            // la transaction et tous ses descendants dans la pool
+        FeeRate score;                  // max(taux propre, descendants) : clé de byDescendantScore_
+    };
+    using NodeMap = std::unordered_map<Hash, Node>;
+
+    /**
+     * Modèle de bloc tenu à jour par chaque ajout et retrait (sous mutex_). Une transaction admise y
+     * entre avec ses ancêtres manquants si elle tient ; un retrait (transaction confirmée, évincée)
+     * libère de la place, comblée au prochain accès depuis le haut de byFeeRate_. Seule une
+     * transaction mieux payée que le modèle déjà plein oblige à le refaire, sur la taille d'un bloc.
+     */
+    struct TemplateState {
+        std::unordered_map<Hash, uint32_t> positions; // txid -> indice dans order
+        std::vector<Hash> order;                   // parents d'abord ; les retraits laissent des trous
+        size_t maxBytes = MAX_BLOCK_BYTES;
+        size_t bytes = 0;
+        Amount fees = 0;
+        FeeRate floor;       // plus faible taux de package retenu
+        bool stale = false;  // à refaire depuis le début
+        bool room = false;   // place libérée par un retrait
+        uint64_t rebuilds = 0;
+    };
+
     const Blockchain& blockchain_;
 
-    std::set<Transaction> transactions_;
-    std::set<OutputReference> spentOutputs_;
+    NodeMap transactions_;                             // indexées par txid
+    FeeRateIndex byFeeRate_;                           // mêmes txids, par taux de frais du package décroissant
+    FeeRateIndex byDescendantScore_;                   // mêmes txids, par score de descendants : l'éviction part du bas
+    std::unordered_map<OutPoint, Hash> spentOutputs_;  // sortie -> transaction de la pool qui la dépense
+    size_t chained_ = 0;                               // entrées ayant un parent dans la pool
     mutable std::mutex mutex_;
 
+    std::atomic<uint64_t> version_{0};                                    // incrémentée à chaque modification
+    mutable std::atomic<std::shared_ptr<const PoolSnapshot>> published_;  // dernière vue construite
+
+    mutable TemplateState template_;
+    std::atomic<uint64_t> templateVersion_{0};                                    // incrémentée quand le modèle change
+    mutable std::atomic<std::shared_ptr<const BlockTemplate>> publishedTemplate_;
+
+    // Limite mémoire (sous mutex_)
+    size_t maxMemory_;
+    size_t memoryUsage_ = 0;
+    uint64_t evicted_ = 0;
+    uint64_t rejectedLowFee_ = 0;
+    uint64_t rejectedPackage_ = 0;
+    uint64_t conflicts_ = 0;
+    mutable double minFeePerKB_ = 0.0;
+    mutable std::chrono::steady_clock::time_point minFeeUpdated_ = std::chrono::steady_clock::now();
+
+    /*Estimation de la mémoire d'une entrée : données de la transaction, bloc partagé et noeuds des index*/
+    static size_t entryMemory(const Transaction& tx);
+    /*Taux minimum après décroissance (plus rapide quand la pool est peu remplie)*/
+    double currentMinFeePerKB_NoLock() const;
+    /*Parents de tx présents dans la pool, gardés en vie par held pendant la vérification hors lock*/
+    void collectParents_NoLock(const Transaction& tx, PendingTxs& pending, std::vector<std::shared_ptr<const PoolEntry>>& held) const;
+    /*Ancêtres (ou descendants) dans la pool, sans doublon. Arrête dès que limit est dépassé*/
+    std::vector<Hash> collectRelatives_NoLock(const std::vector<Hash>& start, std::vector<Hash> Node::* next, size_t limit) const;
+    /*Recalcule le score de descendants de node (après un changement de node.descendants) et sa place dans byDescendantScore_*/
+    void rescore_NoLock(const Hash& txid, Node& node);
+    /*Retire une entrée dont les descendants restent dans la pool (transaction confirmée) ou ont déjà été retirés*/
+    void removeEntry_NoLock(NodeMap::iterator it);
+    /*Retire une entrée et tous ses descendants (éviction). Retourne le nombre de transactions retirées*/
+    size_t removeWithDescendants_NoLock(NodeMap::iterator it);
+    /*Ajoute txid au modèle avec ses ancêtres qui n'y sont pas encore, s'ils tiennent dans la place restante*/
+    bool appendToTemplate_NoLock(const Hash& txid) const;
+    /*Comble le modèle depuis les mieux payées (glouton de fillByFeeRate, arrêt après kMaxSelectionMisses)*/
+    void fillTemplate_NoLock() const;
+    /*Évince le plus faible score de descendants (avec ses descendants) jusqu'à repasser sous maxMemory_ et remonte le taux minimum*/
+    void trimToLimit_NoLock();
+
 public:
 
-    TransactionPool(const Blockchain& blockchain) : blockchain_(blockchain) {}
+    TransactionPool(const Blockchain& blockchain, size_t maxMemory = MAX_POOL_MEMORY)
+        : blockchain_(blockchain), maxMemory_(maxMemory) {}
 
+    /*Vérifie la transaction contre les UTXOs courants puis l'insère. L'appelant tient Blockchain::readLock() : la vérification
+    et l'insertion ne sont pas séparées par un bloc, dont removeConflicts ne verrait pas la transaction*/
     bool addTransaction(const Transaction& tx);
+    /*Réadmet des transactions relues d'une sauvegarde (parents d'abord) : signatures vérifiées en parallèle
+    (SignatureCache), puis admission dans l'ordre contre l'état courant des UTXOs. Retourne le nombre d'acceptées*/
+    size_t restore(const std::vector<Transaction>& txs);
     bool removeTransaction(const Transaction& tx);
+    /*Retire les transactions de la pool qui dépensent une de ces sorties (dépensées par un bloc connecté)
+    et leurs descendants : une recherche par sortie. Retourne le nombre de transactions retirées*/
+    size_t removeConflicts(const std::vector<OutPoint>& spent);
+    /*Sortie dépensée par un input de tx, cherchée dans la chaîne puis parmi les transactions de la pool (nullopt si introuvable)*/
+    std::optional<Output> findSpentOutput(const Transaction& tx, size_t input) const;
+    /*Vrai si un parent référencé par tx n'est ni dans la pool ni confirmé : elle pourra être réévaluée à son arrivée*/
+    bool hasMissingParents(const Transaction& tx) const;
+    /*Vrai si la transaction est déjà dans la pool (doublon relayé par un pair)*/
+    bool contains(const Hash& txid) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return transactions_.count(txid) > 0;
+    }
+
+    /*Vue cohérente de la pool : sans lock si rien n'a changé depuis la dernière vue, reconstruite une seule fois sinon*/
+    std::shared_ptr<const PoolSnapshot> snapshot() const;
+    /*Nombre de transactions en attente, sans construire de vue*/
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return transactions_.size();
+    }
 
+    /*Transactions les mieux payées (frais par octet du package avec ses ancêtres) tenant dans maxBytes, lues dans un snapshot.
+    Un parent précède toujours ses enfants (ordre topologique, prêt pour un bloc)*/
+    std::vector<std::shared_ptr<const PoolEntry>> selectForBlock(size_t maxBytes) const;
+    /*Modèle de bloc courant : sans lock s'il n'a pas changé, sinon complété et publié une seule fois.
+    Coût proportionnel à la taille d'un bloc, jamais à celle de la pool*/
+    std::shared_ptr<const BlockTemplate> blockTemplate() const;
+    /*Change la taille du modèle de bloc (MAX_BLOCK_BYTES par défaut), refait au prochain accès*/
+    void setTemplateBytes(size_t maxBytes);
 
-    const std::set<Transaction>& getTransactions() const{return transactions_;}
+    /*Change la limite mémoire (évince immédiatement si nécessaire)*/
+    void setMaxMemory(size_t maxMemory);
+    Stats getStats() const;
 
 };
 
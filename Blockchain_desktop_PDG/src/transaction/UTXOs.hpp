@@ -2,10 +2,11 @@
 #define UTXOS_HPP
 
 #include "OutputReference.hpp"
+#include "OwnerTable.hpp"
 
 #include <unordered_map>
 #include <set>
 
-using UTXOs = std::unordered_map<PubKey, std::set<OutputReference>>;
+using UTXOs = std::unordered_map<OwnerId, std::set<OutputReference>>;
 
 #endif //UTXOS_HPP
\ No newline at end of file
@@ -0,0 +1,69 @@
+#ifndef WALLET_INDEX_HPP
+#define WALLET_INDEX_HPP
+
+#include "transaction/OwnerTable.hpp"
+#include "transaction/Amount.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+/*Solde courant d'un wallet. Les compteurs sont atomiques : une lecture ne prend aucun lock.*/
+struct WalletBalance {
+    std::atomic<Amount> balance{0};
+    std::atomic<uint32_t> utxoCount{0};
+};
+
+/**
+ * Index des soldes par propriétaire (OwnerId), mis à jour de façon incrémentale à chaque sortie
+ * ajoutée ou dépensée (addBlock). Évite de reparcourir toutes les UTXOs d'un wallet
+ * pour connaître son solde.
+ */
+class WalletIndex {
+private:
+    // les noeuds d'un unordered_map ne bougent jamais : les références retournées restent valides
+    std::unordered_map<OwnerId, WalletBalance> wallets_;
+    mutable std::shared_mutex mutex_;
+
+    WalletBalance& getOrCreate(OwnerId owner) {
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            auto it = wallets_.find(owner);
+            if (it != wallets_.end()) return it->second;
+        }
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        return wallets_.try_emplace(owner).first->second;
+    }
+
+public:
+    /*Retourne l'entrée du wallet (créée si absente). La référence reste valide pendant toute la durée de vie de l'index*/
+    const WalletBalance& track(OwnerId owner) { return getOrCreate(owner); }
+
+    /*Ajoute une sortie non dépensée au solde du propriétaire*/
+    void credit(OwnerId owner, Amount value) {
+        WalletBalance& wallet = getOrCreate(owner);
+        wallet.balance.fetch_add(value, std::memory_order_relaxed);
+        wallet.utxoCount.fetch_add(1, std::memory_order_release);
+    }
+    /*Retire une sortie dépensée du solde du propriétaire*/
+    void debit(OwnerId owner, Amount value) {
+        WalletBalance& wallet = getOrCreate(owner);
+        wallet.balance.fetch_sub(value, std::memory_order_relaxed);
+        wallet.utxoCount.fetch_sub(1, std::memory_order_release);
+    }
+
+    Amount getBalance(OwnerId owner) const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = wallets_.find(owner);
+        return it != wallets_.end() ? it->second.balance.load(std::memory_order_acquire) : 0;
+    }
+    uint32_t getUtxoCount(OwnerId owner) const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = wallets_.find(owner);
+        return it != wallets_.end() ? it->second.utxoCount.load(std::memory_order_acquire) : 0;
+    }
+};
+
+#endif // WALLET_INDEX_HPP
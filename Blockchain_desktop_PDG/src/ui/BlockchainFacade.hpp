@@ -15,6 +15,7 @@ class BlockchainFacade : public QObject {
     Q_PROPERTY(QString publicKey READ getPublicKeyString CONSTANT)
     Q_PROPERTY(double lastHashrate READ getLastHashrateMHs NOTIFY periodicUpdate)
     Q_PROPERTY(double lastTPS READ getLastTPS NOTIFY periodicUpdate)
+    Q_PROPERTY(int pendingCount READ getPendingCount NOTIFY periodicUpdate)
 
 public:
     explicit BlockchainFacade(Blockchain& chain, EVP_PKEY* privKey, QObject* parent=nullptr)
@@ -22,6 +23,7 @@ public:
     {
 
         minerPubKey = crypto::getPubKey(privKey);
+        walletBalance_ = &m_chain.trackWallet(minerPubKey);
         // callback core -> signal Qt (thread-safe via QueuedConnection)
         m_chain.setOnNewBlock([this](const Block& block) {
 
@@ -57,7 +59,8 @@ public:
         emit miningChanged();
     }
     Q_INVOKABLE double walletBalance() const {
-        return m_chain.getWalletBalance(minerPubKey);
+        // lecture atomique de l'index des soldes, sans lock sur la blockchain
+        return amountToCoins(walletBalance_->balance.load(std::memory_order_acquire));
     }
     Q_INVOKABLE QString getTransactionAt(int index) const {
         if (index >= 0 && index < walletTransactions.size()) {
@@ -68,7 +71,12 @@ public:
     Q_INVOKABLE void sendTransaction(const QString& toPubKey, double amount) {
         std::cout << "[C++] Sending " << amount << " SKBC to " << toPubKey.toStdString() << std::endl;
         try {
-            Transaction tx = Transaction::createWithFromPub(privKey, minerPubKey, toPubKey.toStdString(), amount, 0.0, m_chain);
+            // Adresse saisie en hexadécimal (66 caractères) ; fromHex lève une exception si elle est invalide
+            const PubKey to = PubKey::fromHex(toPubKey.trimmed().toStdString());
+            if (!crypto::decodePubKey(to)) {
+                throw std::invalid_argument("Invalid public key");
+            }
+            Transaction tx = Transaction::createWithFromPub(privKey, minerPubKey, to, amountFromCoins(amount), 0, m_chain);
             m_chain.addAndBroadCastTransaction(tx);
         } catch (const std::exception& e) {
             std::cerr << "Error creating transaction: " << e.what() << std::endl;
@@ -88,7 +96,7 @@ public:
     }
 
     QString getPublicKeyString() const {
-        return QString::fromStdString(minerPubKey);
+        return QString::fromStdString(minerPubKey.toHex());
     }
 
 
@@ -96,6 +104,8 @@ public:
     bool isMining() const { return m_chain.isMining(); }
     uint32_t blockCount() const { return m_chain.size(); }
     int getTransactionCount() const { return walletTransactions.size(); }
+    /*Transactions en attente : compteur de la pool lu sous son mutex (lock bref, aucun snapshot construit)*/
+    int getPendingCount() const { return static_cast<int>(m_chain.getTransactionPool().size()); }
 
 signals:
     void blockCountChanged();
@@ -106,6 +116,7 @@ private:
     Blockchain& m_chain;
     EVP_PKEY* privKey; // clé privée du wallet
     PubKey minerPubKey;
+    const WalletBalance* walletBalance_; // entrée de l'index des soldes pour minerPubKey
     std::vector<Transaction> walletTransactions;
     QTimer* m_periodicTimer; // timer pour emission périodique
 };
\ No newline at end of file
@@ -0,0 +1,1027 @@
+#include <QtTest/QtTest>
+
+#include <array>
+#include <filesystem>
+#include <random>
+#include <set>
+#include <sstream>
+#include <vector>
+
+#include <cereal/archives/binary.hpp>
+
+#include "transaction/WalletIndex.hpp"
+#include "transaction/OwnerTable.hpp"
+#include "transaction/Output.hpp"
+#include "transaction/OutputReference.hpp"
+#include "transaction/Transaction.hpp"
+#include "transaction/BlockTransactions.hpp"
+#include "transaction/FeeRateIndex.hpp"
+#include "transaction/MempoolFile.hpp"
+#include "network/BinaryProtocol.hpp"
+#include "network/AdmissionQueue.hpp"
+#include "Block.hpp"
+#include "Blockchain.hpp"
+#include "cryptography/VerificationPool.hpp"
+#include "cryptography/SignatureCache.hpp"
+#include "cryptography/PubKeyCache.hpp"
+#include "cryptography/Sha256.hpp"
+
+// Même disposition qu'OutputReference, sérialisée champ par champ (chemin générique de cereal)
+struct FieldwiseRef {
+    uint32_t blockIndex;
+    uint16_t txIndex;
+    uint16_t outputIndex;
+    template<class Archive>
+    void serialize(Archive& ar) { ar(blockIndex, txIndex, outputIndex); }
+};
+
+// Benchmarks des chemins critiques du noeud (lancer avec ./bench_blockchain)
+class BenchBlockchain : public QObject {
+    Q_OBJECT
+
+    // BlockTransactions n'a pas de constructeur public depuis un vecteur : même format binaire que ar(txs)
+    static BlockTransactions loadBlockTransactions(const std::vector<Transaction>& txs) {
+        std::stringstream ss(std::ios::in | std::ios::out | std::ios::binary);
+        {
+            cereal::BinaryOutputArchive ar(ss);
+            ar(txs);
+        }
+        BlockTransactions loaded;
+        {
+            cereal::BinaryInputArchive ar(ss);
+            ar(loaded);
+        }
+        return loaded;
+    }
+
+    // Ancien BinaryProtocol : ostringstream -> std::string -> std::vector, et copie en std::string pour relire
+    template<class T>
+    static std::vector<uint8_t> serializeWithStream(const T& obj) {
+        std::ostringstream oss(std::ios::binary);
+        {
+            cereal::BinaryOutputArchive ar(oss);
+            ar(obj);
+        }
+        auto str = oss.str();
+        return std::vector<uint8_t>(str.begin(), str.end());
+    }
+    template<class T>
+    static T deserializeWithStream(const std::vector<uint8_t>& data) {
+        std::istringstream iss(std::string(reinterpret_cast<const char*>(data.data()), data.size()), std::ios::binary);
+        cereal::BinaryInputArchive ar(iss);
+        T obj;
+        ar(obj);
+        return obj;
+    }
+
+    // Bloc de 2000 transactions (Block n'est construit que par le minage ou la désérialisation)
+    Block makeBlock() const {
+        std::vector<uint8_t> bytes;
+        {
+            cereal::ByteOutputArchive ar(bytes);
+            ar(uint32_t{42}, uint32_t{7}, uint32_t{1700000000}, Target::createInitialTarget(),
+               loadBlockTransactions(signedTxs), crypto::hashData("prev"), crypto::hashData("hash"));
+        }
+        return BinaryProtocol::deserializeObject<Block>(bytes.data(), bytes.size());
+    }
+
+    // Bloc 0 (accepté sans preuve de travail) dont l'unique transaction crée les sorties données
+    static Block makeGenesis(const Outputs& outputs) {
+        std::vector<uint8_t> bytes;
+        {
+            cereal::ByteOutputArchive ar(bytes);
+            ar(uint32_t{0}, uint32_t{0}, uint32_t{1700000000}, Target::createInitialTarget(),
+               loadBlockTransactions({Transaction({}, outputs)}), Hash{}, crypto::hashData("genesis"));
+        }
+        return BinaryProtocol::deserializeObject<Block>(bytes.data(), bytes.size());
+    }
+
+    static constexpr uint32_t kWalletUtxos = 100000;
+
+    // Point générateur G de secp256k1 (clé publique valide quelconque)
+    PubKey owner = PubKey::fromHex("0279be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798");
+    OwnerId ownerId = OwnerTable::instance().intern(owner);
+    std::vector<Output> outputs;        // une sortie par "bloc"
+    std::set<OutputReference> utxoSet;  // UTXOs du wallet
+    WalletIndex index;
+
+    static constexpr size_t kBlockSignatures = 2000;
+
+    // Signatures d'un "gros bloc" : un message signé par transaction
+    std::vector<std::string> messages;
+    std::vector<Signature> signatures;
+    std::vector<PubKey> signers;
+    std::vector<Transaction> signedTxs; // mêmes clés, transactions complètes
+
+    // Chaîne réelle : le bloc 0 crée kFundedOutputs sorties de 10 SKBC, la sortie i appartient à fundingKeys[i % 8]
+    static constexpr size_t kFundedOutputs = 400;
+    std::vector<EVP_PKEY*> fundingKeys;
+
+    void fund(Blockchain& chain) const {
+        Outputs funding;
+        for (size_t i = 0; i < kFundedOutputs; ++i) funding.emplace_back(10 * COIN, crypto::getPubKey(fundingKeys[i % 8]));
+        QVERIFY(chain.addBlock(makeGenesis(funding)));
+    }
+    /*Dépense la sortie financée donnée vers owner en laissant fee de frais*/
+    Transaction spend(size_t output, Amount fee) const {
+        Transaction tx({OutputReference(0, 0, static_cast<uint16_t>(output))}, {Output(10 * COIN - fee, owner)});
+        tx.sign(fundingKeys[output % 8]);
+        return tx;
+    }
+    /*Dépense la première sortie de parent, encore non confirmé, vers fundingKeys[key % 8]*/
+    Transaction spendUnconfirmed(const Transaction& parent, size_t key, Amount fee) const {
+        Transaction child({OutputReference(OutputReference::UNCONFIRMED, 0, 0)},
+                          {Output(parent.getOutputs()[0].getValue() - fee, crypto::getPubKey(fundingKeys[key % 8]))},
+                          {parent.getTxid()});
+        child.sign(fundingKeys[key % 8]);
+        return child;
+    }
+
+private slots:
+    void initTestCase() {
+        outputs.reserve(kWalletUtxos);
+        for (uint32_t i = 0; i < kWalletUtxos; ++i) {
+            outputs.emplace_back((1 + i % 7) * COIN, owner);
+            utxoSet.insert(OutputReference(i, 0, 0));
+            index.credit(ownerId, outputs.back().getValue());
+        }
+        QCOMPARE(index.getUtxoCount(ownerId), kWalletUtxos);
+
+        std::vector<EVP_PKEY*> keys;
+        for (int k = 0; k < 16; ++k) keys.push_back(crypto::createPrivateKey());
+        for (size_t i = 0; i < kBlockSignatures; ++i) {
+            EVP_PKEY* key = keys[i % keys.size()];
+            messages.push_back("Inputs:\n  Block: " + std::to_string(i) + ", Tx: 0, Out: 0\n");
+            signatures.push_back(crypto::signData(messages.back(), key));
+            signers.push_back(crypto::getPubKey(key));
+
+            Transaction tx({OutputReference(static_cast<uint32_t>(i), 0, 0)}, {Output(COIN, owner)});
+            tx.sign(key);
+            signedTxs.push_back(tx);
+        }
+        for (EVP_PKEY* key : keys) EVP_PKEY_free(key);
+        for (int k = 0; k < 8; ++k) fundingKeys.push_back(crypto::createPrivateKey());
+    }
+    void cleanupTestCase() {
+        for (EVP_PKEY* key : fundingKeys) EVP_PKEY_free(key);
+    }
+
+    // Ancien getWalletBalance : parcours de toutes les UTXOs du wallet
+    void walletBalanceUtxoWalk100k() {
+        Amount balance = 0;
+        QBENCHMARK {
+            balance = 0;
+            for (const auto& ref : utxoSet) {
+                balance += outputs[ref.getBlockIndex()].getValue();
+            }
+        }
+        QCOMPARE(balance, index.getBalance(ownerId));
+    }
+
+    // Lecture dans l'index des soldes
+    void walletBalanceIndex100k() {
+        Amount balance = 0;
+        QBENCHMARK {
+            balance = index.getBalance(ownerId);
+        }
+        QVERIFY(balance > 0);
+    }
+
+    // Lecture sans lock via l'entrée conservée (chemin de la facade QML)
+    void walletBalanceTracked100k() {
+        const WalletBalance& wallet = index.track(ownerId);
+        Amount balance = 0;
+        QBENCHMARK {
+            balance = wallet.balance.load(std::memory_order_acquire);
+        }
+        QVERIFY(balance > 0);
+    }
+
+    // Vérification des signatures d'un bloc, une par une sur le thread appelant
+    void blockSignaturesSequential() {
+        bool ok = true;
+        QBENCHMARK {
+            ok = true;
+            for (size_t i = 0; i < kBlockSignatures && ok; ++i) {
+                ok = crypto::verifySignature(messages[i], signatures[i], signers[i]);
+            }
+        }
+        QVERIFY(ok);
+    }
+
+    // Même lot réparti sur le VerificationPool
+    void blockSignaturesParallel() {
+        auto& pool = VerificationPool::instance();
+        qInfo() << "VerificationPool workers:" << pool.workerCount() + 1;
+        bool ok = true;
+        QBENCHMARK {
+            ok = pool.run(kBlockSignatures, [this](size_t i) {
+                return crypto::verifySignature(messages[i], signatures[i], signers[i]);
+            });
+        }
+        QVERIFY(ok);
+
+        // Arrêt au premier échec
+        Signature saved = signatures[kBlockSignatures / 2];
+        signatures[kBlockSignatures / 2][0] ^= 0x01;
+        QVERIFY(!pool.run(kBlockSignatures, [this](size_t i) {
+            return crypto::verifySignature(messages[i], signatures[i], signers[i]);
+        }));
+        signatures[kBlockSignatures / 2] = saved;
+    }
+
+    // Hachage d'un en-tête de bloc (~80 octets) : version std::string
+    void hashHeaderString() {
+        const std::string header(80, 'h');
+        Hash hash;
+        QBENCHMARK {
+            hash = crypto::hashData(header);
+        }
+        unsigned char expected[SHA256_DIGEST_LENGTH];
+        SHA256(reinterpret_cast<const unsigned char*>(header.data()), header.size(), expected);
+        QVERIFY(std::memcmp(hash.data(), expected, SHA256_DIGEST_LENGTH) == 0);
+    }
+
+    // Même en-tête, buffer de sortie fourni : aucune allocation dans la boucle
+    void hashHeaderSpan() {
+        const std::string header(80, 'h');
+        std::array<uint8_t, crypto::HASH_SIZE> out{};
+        QBENCHMARK {
+            crypto::hashData(crypto::asBytes(header), out);
+        }
+        QVERIFY(std::memcmp(crypto::hashData(header).data(), out.data(), out.size()) == 0);
+    }
+
+    // Débit SHA-256 par back end et par taille de message
+    void sha256Single_data() {
+        QTest::addColumn<int>("backend");
+        QTest::addColumn<int>("size");
+        for (auto backend : {sha256::Backend::Portable, sha256::Backend::Avx2, sha256::Backend::ShaNi}) {
+            if (!sha256::isSupported(backend)) continue;
+            for (int size : {32, 80, 256, 1024, 16384}) {
+                QTest::addRow("%s/%d", sha256::backendName(backend), size) << static_cast<int>(backend) << size;
+            }
+        }
+    }
+    void sha256Single() {
+        QFETCH(int, backend);
+        QFETCH(int, size);
+        const sha256::Backend previous = sha256::activeBackend();
+        QVERIFY(sha256::setBackend(static_cast<sha256::Backend>(backend)));
+        const std::vector<uint8_t> message(size, 0x5A);
+        std::array<uint8_t, sha256::DIGEST_SIZE> out{};
+        QBENCHMARK {
+            sha256::hash(message, out);
+        }
+        sha256::setBackend(previous);
+    }
+
+    // Lot de 1024 messages de même taille (ex. un niveau d'arbre de Merkle)
+    void sha256Batch_data() {
+        sha256Single_data();
+    }
+    void sha256Batch() {
+        QFETCH(int, backend);
+        QFETCH(int, size);
+        const sha256::Backend previous = sha256::activeBackend();
+        QVERIFY(sha256::setBackend(static_cast<sha256::Backend>(backend)));
+        std::vector<std::vector<uint8_t>> messages(1024, std::vector<uint8_t>(size, 0x5A));
+        std::vector<std::span<const uint8_t>> spans(messages.begin(), messages.end());
+        std::vector<uint8_t> out(messages.size() * sha256::DIGEST_SIZE);
+        QBENCHMARK {
+            sha256::hashMany(spans, out.data());
+        }
+        sha256::setBackend(previous);
+    }
+
+    // Mémoire et taille sur le réseau des 2 hashes d'un bloc : std::string (ancien type) contre Hash
+    void hashMemoryPerBlock() {
+        const std::string oldHash(Hash::SIZE, '\x7f');
+        const char* buffer = oldHash.data();
+        const char* object = reinterpret_cast<const char*>(&oldHash);
+        const bool onHeap = buffer < object || buffer >= object + sizeof(oldHash);
+        const size_t oldPerHash = sizeof(std::string) + (onHeap ? oldHash.capacity() + 1 : 0);
+        const size_t newPerHash = sizeof(Hash);
+
+        qInfo() << "memory per block (previousHash + hash):" << 2 * oldPerHash << "->" << 2 * newPerHash
+                << "bytes, heap allocations:" << (onHeap ? 2 : 0) << "-> 0";
+        qInfo() << "wire bytes per block:" << 2 * (sizeof(uint64_t) + Hash::SIZE) << "->" << 2 * Hash::SIZE;
+        QVERIFY(newPerHash <= oldPerHash);
+    }
+
+    // Comparaison previousHash == getHash() : std::string contre Hash
+    void hashCompareString() {
+        const std::string a(Hash::SIZE, '\x11');
+        std::string b = a;
+        bool equal = false;
+        QBENCHMARK {
+            equal = (a == b);
+        }
+        QVERIFY(equal);
+    }
+    void hashCompareFixed() {
+        const Hash a = crypto::hashData("bloc");
+        Hash b = a;
+        bool equal = false;
+        QBENCHMARK {
+            equal = (a == b);
+        }
+        QVERIFY(equal);
+        QCOMPARE(Hash::fromHex(a.toHex()), a);
+    }
+
+    // Vérification d'une signature en décodant la clé compressée à chaque appel
+    void verifyPerKeyWithoutCache() {
+        bool ok = true;
+        QBENCHMARK {
+            ok = crypto::verifySignature(messages[0], signatures[0], crypto::decodePubKey(signers[0]));
+        }
+        QVERIFY(ok);
+    }
+
+    // Même clé, décodée une fois puis servie par le PubKeyCache
+    void verifyPerKeyWithCache() {
+        PubKeyCache::instance().clear();
+        bool ok = true;
+        QBENCHMARK {
+            ok = crypto::verifySignature(messages[0], signatures[0], signers[0]);
+        }
+        QVERIFY(ok);
+        QCOMPARE(PubKeyCache::instance().getMisses(), static_cast<uint64_t>(1));
+    }
+
+    // Taille sur le réseau d'une clé compressée contre l'ancien PEM (aller-retour et rejets vérifiés dans test_protocol)
+    void pubKeyCompressedRoundTrip() {
+        EVP_PKEY* key = crypto::createPrivateKey();
+        // Ancien format : corps PEM (SubjectPublicKeyInfo DER en base64) avec préfixe de longueur cereal
+        const int derLen = i2d_PUBKEY(key, nullptr);
+        const size_t oldKeyBytes = sizeof(uint64_t) + 4 * ((derLen + 2) / 3);
+        qInfo() << "wire bytes per Output (value + pubKey):" << sizeof(double) + oldKeyBytes
+                << "->" << sizeof(double) + PubKey::SIZE;
+        EVP_PKEY_free(key);
+    }
+
+    // Ancien getStrToSign : texte (ostringstream, doubles formatés, clés) puis SHA-256, à chaque signature/vérification
+    void sigHashText() {
+        const Inputs inputs(8, OutputReference(123456, 7, 1));
+        const Outputs outputs{Output(12 * COIN + COIN / 2, owner), Output(3 * COIN + COIN / 4, signers[0])};
+        Hash hash;
+        QBENCHMARK {
+            Transaction tx(inputs, outputs);
+            std::ostringstream oss;
+            oss << "Inputs:\n";
+            for (const auto& input : tx.getInputs()) oss << "  " << input.toString() << "\n";
+            oss << "Outputs:\n";
+            for (const auto& output : tx.getOutputs()) oss << "  " << output.toString() << "\n";
+            hash = crypto::hashData(oss.str());
+        }
+        QVERIFY(!hash.isZero());
+    }
+    // Encodage binaire de taille fixe haché en une passe (premier appel)
+    void sigHashBinary() {
+        const Inputs inputs(8, OutputReference(123456, 7, 1));
+        const Outputs outputs{Output(12 * COIN + COIN / 2, owner), Output(3 * COIN + COIN / 4, signers[0])};
+        Hash hash;
+        QBENCHMARK {
+            Transaction tx(inputs, outputs);
+            hash = tx.getSigHash();
+        }
+        QVERIFY(!hash.isZero());
+    }
+    // Appels suivants : valeur conservée sur la transaction
+    void sigHashMemoized() {
+        const Transaction tx(Inputs(8, OutputReference(123456, 7, 1)), {Output(12 * COIN + COIN / 2, owner)});
+        const Hash first = tx.getSigHash();
+        Hash hash;
+        QBENCHMARK {
+            hash = tx.getSigHash();
+        }
+        QCOMPARE(hash, first);
+        QCOMPARE(Transaction(tx).getSigHash(), first);
+    }
+
+    // txid : stable après (dé)sérialisation, distinct du sighash, change avec la signature
+    void txidIdentity() {
+        const Transaction& tx = signedTxs[0];
+        std::stringstream ss(std::ios::in | std::ios::out | std::ios::binary);
+        {
+            cereal::BinaryOutputArchive ar(ss);
+            ar(tx);
+        }
+        Transaction copy;
+        {
+            cereal::BinaryInputArchive ar(ss);
+            ar(copy);
+        }
+        QCOMPARE(copy.getTxid(), tx.getTxid());
+        QVERIFY(tx.getTxid() != tx.getSigHash());
+        QVERIFY(signedTxs[1].getTxid() != tx.getTxid());
+    }
+
+    // Hash d'en-tête par nonce, bloc de 2000 transactions : ancien préimage (toutes les transactions sérialisées)
+    void blockHashFullSerialization() {
+        Hash hash;
+        uint32_t nonce = 0;
+        QBENCHMARK {
+            std::ostringstream oss(std::ios::binary);
+            {
+                cereal::BinaryOutputArchive ar(oss);
+                ar(++nonce, signedTxs);
+            }
+            hash = crypto::hashData(oss.str());
+        }
+        QVERIFY(!hash.isZero());
+    }
+    // Racine de Merkle d'un bloc de 2000 transactions (txids compris), calculée une fois par bloc
+    void merkleRoot2000() {
+        const BlockTransactions txs = loadBlockTransactions(signedTxs);
+        Hash root;
+        QBENCHMARK_ONCE {
+            root = txs.getMerkleRoot();
+        }
+        QVERIFY(!root.isZero());
+    }
+    // Nouveau préimage : en-tête de taille fixe avec la racine de Merkle déjà calculée
+    void blockHashMerkleHeader() {
+        const BlockTransactions txs = loadBlockTransactions(signedTxs);
+        txs.getMerkleRoot();
+        Hash hash;
+        uint32_t nonce = 0;
+        QBENCHMARK {
+            std::ostringstream oss(std::ios::binary);
+            {
+                cereal::BinaryOutputArchive ar(oss);
+                ar(++nonce, txs.getMerkleRoot());
+            }
+            hash = crypto::hashData(oss.str());
+        }
+        QVERIFY(!hash.isZero());
+    }
+
+    // Somme des entrées d'une transaction (200 montants) : double dépend de l'ordre, Amount est exact
+    void feeSumDouble() {
+        std::vector<double> values;
+        for (int i = 0; i < 200; ++i) values.push_back((i * 7919 % 100000) / 1000.0 + 0.001);
+        double forward = 0.0;
+        QBENCHMARK {
+            forward = 0.0;
+            for (double v : values) forward += v;
+        }
+        double backward = 0.0;
+        for (auto it = values.rbegin(); it != values.rend(); ++it) backward += *it;
+        qInfo() << "double sum forward - backward:" << forward - backward;
+    }
+    void feeSumAmount() {
+        std::vector<Amount> values;
+        for (int i = 0; i < 200; ++i) values.push_back(amountFromCoins((i * 7919 % 100000) / 1000.0 + 0.001));
+        Amount forward = 0;
+        QBENCHMARK {
+            forward = 0;
+            for (Amount v : values) forward = checkedAdd(forward, v);
+        }
+        Amount backward = 0;
+        for (auto it = values.rbegin(); it != values.rend(); ++it) backward = checkedAdd(backward, *it);
+        QCOMPARE(forward, backward);
+        bool overflow = false;
+        try { checkedAdd(MAX_MONEY, 1); } catch (const std::overflow_error&) { overflow = true; }
+        QVERIFY(overflow);
+    }
+
+    // Pool de 100k transactions : sélection des N mieux payées par tri à chaque bloc contre index maintenu
+    static std::vector<std::pair<Hash, FeeRate>> makePoolRates(size_t count) {
+        std::mt19937_64 rng(7);
+        std::vector<std::pair<Hash, FeeRate>> rates;
+        for (size_t i = 0; i < count; ++i) {
+            Hash txid;
+            for (auto& b : txid.bytes) b = static_cast<uint8_t>(rng());
+            rates.emplace_back(txid, FeeRate{static_cast<Amount>(rng() % (COIN / 100)), static_cast<uint32_t>(150 + rng() % 2000)});
+        }
+        return rates;
+    }
+    void feeRateSortPerBlock100k() {
+        const auto rates = makePoolRates(100000);
+        std::vector<std::pair<Hash, FeeRate>> work;
+        QBENCHMARK {
+            work = rates;
+            std::partial_sort(work.begin(), work.begin() + 1000, work.end(),
+                              [](const auto& a, const auto& b) { return a.second > b.second; });
+        }
+    }
+    void feeRateIndex100k() {
+        const auto rates = makePoolRates(100000);
+        FeeRateIndex index;
+        QBENCHMARK_ONCE {
+            for (const auto& [txid, rate] : rates) index.insert(txid, rate);
+        }
+        std::vector<Hash> top;
+        QBENCHMARK {
+            top = index.top(1000);
+        }
+        QCOMPARE(top.size(), size_t{1000});
+
+        // Même sélection que le tri complet (au txid près pour les taux égaux)
+        auto sorted = rates;
+        std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+            return a.second > b.second || (a.second == b.second && a.first < b.first);
+        });
+        for (size_t i = 0; i < top.size(); ++i) QCOMPARE(top[i], sorted[i].first);
+
+        // Retrait des transactions minées : la suivante remonte en tête
+        QBENCHMARK_ONCE {
+            for (size_t i = 0; i < 1000; ++i) index.erase(sorted[i].first, sorted[i].second);
+        }
+        QCOMPARE(index.top(1).front(), sorted[1000].first);
+        QCOMPARE(index.size(), rates.size() - 1000);
+    }
+
+    // Remplissage d'un bloc de MAX_BLOCK_BYTES depuis la pool de 100k (avant : 10 transactions par bloc)
+    void blockSelectionByBytes() {
+        const auto rates = makePoolRates(100000);
+        FeeRateIndex index;
+        for (const auto& [txid, rate] : rates) index.insert(txid, rate);
+        std::vector<Hash> selected;
+        QBENCHMARK {
+            selected = index.select(MAX_BLOCK_BYTES);
+        }
+        std::unordered_map<Hash, FeeRate> byTxid(rates.begin(), rates.end());
+        auto total = [&](const std::vector<Hash>& txids) {
+            FeeRate sum{0, 0};
+            for (const auto& txid : txids) {
+                sum.fee += byTxid[txid].fee;
+                sum.size += byTxid[txid].size;
+            }
+            return sum;
+        };
+        const FeeRate block = total(selected);
+        const FeeRate legacy = total(index.top(10));
+        QVERIFY(block.size <= MAX_BLOCK_BYTES);
+        // Même formule que computeTPS_NoLock (tx hors coinbase / durée) pour un bloc toutes les 5 minutes
+        qInfo() << "txs per block:" << 10 << "->" << selected.size() << "(" << block.size << "bytes, fees"
+                << amountToCoins(legacy.fee) << "->" << amountToCoins(block.fee) << "SKBC), TPS at 300 s:"
+                << 10 / 300.0 << "->" << selected.size() / 300.0;
+
+        // Une grosse transaction mieux payée qui ne rentre plus est sautée : les petites comblent la place
+        FeeRateIndex small;
+        small.insert(crypto::hashData("big"), FeeRate{1000 * 700, 700});
+        small.insert(crypto::hashData("a"), FeeRate{500 * 600, 600});
+        small.insert(crypto::hashData("b"), FeeRate{10 * 300, 300});
+        QCOMPARE(small.select(1000).size(), size_t{2});
+        QCOMPARE(small.select(1000).back(), crypto::hashData("b"));
+    }
+
+    // Rafale de 2000 transactions reçues : temps pendant lequel le thread réseau est occupé
+    void admissionInline() {
+        SignatureCache::instance().clear();
+        size_t accepted = 0;
+        QBENCHMARK_ONCE {
+            for (size_t i = 0; i < signedTxs.size(); ++i) accepted += signedTxs[i].verifySignature(signers[i]);
+        }
+        QCOMPARE(accepted, signedTxs.size());
+    }
+    void admissionQueued() {
+        SignatureCache::instance().clear();
+        std::unordered_map<Hash, PubKey> owners;
+        for (size_t i = 0; i < signedTxs.size(); ++i) owners.emplace(signedTxs[i].getTxid(), signers[i]);
+        std::set<Hash> pool;
+        size_t relayed = 0;
+        AdmissionQueue queue(
+            [&owners](const Transaction& tx) { return tx.verifySignature(owners.at(tx.getTxid())); },
+            [&pool](const Transaction& tx) {
+                return pool.insert(tx.getTxid()).second ? AdmissionQueue::Verdict::Accepted : AdmissionQueue::Verdict::Rejected;
+            },
+            [&relayed](const Transaction&, const PeerInfo&) { ++relayed; });
+        const PeerInfo peer("10.0.0.1", 8185);
+
+        const auto start = std::chrono::steady_clock::now();
+        QBENCHMARK_ONCE {
+            for (const auto& tx : signedTxs) queue.enqueue(tx, peer);
+            queue.enqueue(signedTxs[0], peer); // doublon : rejeté par admit
+        }
+        queue.drain();
+        const double totalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        const auto stats = queue.getStats();
+        qInfo() << "admitted" << stats.accepted << "rejected" << stats.rejected << "in" << totalMs << "ms:"
+                << stats.batches << "batches (avg" << stats.avgBatchSize() << "), max depth" << stats.maxDepth
+                << ", latency avg" << stats.avgLatencyUs / 1000 << "ms max" << stats.maxLatencyUs / 1000 << "ms";
+        QCOMPARE(stats.accepted, uint64_t{signedTxs.size()});
+        QCOMPARE(stats.rejected, uint64_t{1});
+        QCOMPARE(relayed, signedTxs.size());
+        QCOMPARE(stats.depth, size_t{0});
+    }
+
+    // Snapshots de la pool : lecture sans lock pendant que la pool admet des transactions
+    void poolSnapshots() {
+        constexpr size_t kTxs = kFundedOutputs;
+        Blockchain chain;
+        fund(chain);
+        std::vector<Transaction> txs;
+        for (size_t i = 0; i < kTxs; ++i) txs.push_back(spend(i, static_cast<Amount>(1000 + i)));
+
+        TransactionPool& pool = chain.getTransactionPool();
+        for (size_t i = 0; i < kTxs / 2; ++i) QVERIFY(pool.addTransaction(txs[i]));
+        const auto first = pool.snapshot();
+        QCOMPARE(first->byFeeRate.size(), kTxs / 2);
+
+        // Écrivain : l'autre moitié ; lecteur : vues toujours triées et cohérentes avec leur version
+        std::atomic<bool> writing{true};
+        std::thread writer([&] {
+            for (size_t i = kTxs / 2; i < kTxs; ++i) pool.addTransaction(txs[i]);
+            writing = false;
+        });
+        size_t reads = 0;
+        uint64_t lastVersion = 0;
+        bool consistent = true;
+        while (writing || reads == 0) {
+            const auto view = pool.snapshot();
+            size_t bytes = 0;
+            for (size_t i = 0; i < view->byFeeRate.size(); ++i) {
+                bytes += view->byFeeRate[i]->rate.size;
+                if (i > 0 && view->byFeeRate[i]->rate > view->byFeeRate[i - 1]->rate) consistent = false;
+            }
+            consistent = consistent && bytes == view->bytes && view->version >= lastVersion;
+            lastVersion = view->version;
+            ++reads;
+        }
+        writer.join();
+        QVERIFY(consistent);
+        QCOMPARE(first->byFeeRate.size(), kTxs / 2); // une vue publiée ne change jamais
+        QCOMPARE(pool.size(), kTxs);
+        qInfo() << "snapshots read during admission:" << reads;
+
+        std::shared_ptr<const PoolSnapshot> view;
+        QBENCHMARK {
+            view = pool.snapshot(); // inchangée : chargement atomique seul
+        }
+        QVERIFY(pool.removeTransaction(txs.back()));
+        QBENCHMARK_ONCE {
+            view = pool.snapshot(); // reconstruite une fois après modification
+        }
+        QCOMPARE(view->byFeeRate.size(), kTxs - 1);
+    }
+
+    // Afflux de transactions : éviction des moins bien payées pour repasser sous la limite mémoire (comportement vérifié dans test_pool)
+    void poolMemoryCap() {
+        Blockchain chain;
+        fund(chain);
+        TransactionPool& pool = chain.getTransactionPool();
+        constexpr size_t kFlood = 300;
+        for (size_t i = 0; i < kFlood; ++i) {
+            QVERIFY(pool.addTransaction(spend(i, static_cast<Amount>(1000 * (1 + i % 50)))));
+        }
+        const auto full = pool.getStats();
+        qInfo() << "accounted memory:" << full.memoryUsage / full.count << "bytes per transaction";
+
+        QBENCHMARK_ONCE {
+            pool.setMaxMemory(full.memoryUsage / 3);
+        }
+        const auto trimmed = pool.getStats();
+        qInfo() << "evicted" << trimmed.evicted << "of" << kFlood << ", kept" << trimmed.count << "in"
+                << trimmed.memoryUsage << "/" << trimmed.maxMemory << "bytes, min fee" << trimmed.minFeePerKB << "per kB";
+    }
+
+    // Sélection par package sur une pool avec des chaînes non confirmées (ordre et limites vérifiés dans test_pool)
+    void chainedTransactions() {
+        Blockchain chain;
+        fund(chain);
+        TransactionPool& pool = chain.getTransactionPool();
+        for (size_t i = 1; i <= 20; ++i) QVERIFY(pool.addTransaction(spend(i, 5000)));
+        Transaction link({OutputReference(0, 0, 300)}, {Output(10 * COIN - 1000, crypto::getPubKey(fundingKeys[300 % 8]))});
+        link.sign(fundingKeys[300 % 8]);
+        QVERIFY(pool.addTransaction(link));
+        for (size_t length = 1; length < TransactionPool::kMaxAncestors; ++length) {
+            link = spendUnconfirmed(link, 300, 1000);
+            QVERIFY(pool.addTransaction(link));
+        }
+        qInfo() << "pool:" << pool.size() << "transactions," << pool.getStats().chained << "with an unconfirmed parent";
+
+        std::vector<std::shared_ptr<const PoolEntry>> block;
+        QBENCHMARK {
+            block = pool.selectForBlock(MAX_BLOCK_BYTES);
+        }
+    }
+
+    // Chaîne reçue dans le désordre : latence jusqu'à l'admission de toute la chaîne via l'OrphanPool (limites vérifiées dans test_pool)
+    void orphanTransactions() {
+        Blockchain chain;
+        fund(chain);
+        constexpr size_t kChain = 10;
+        std::vector<Transaction> txs{Transaction({OutputReference(0, 0, 5)}, {Output(10 * COIN - 1000, crypto::getPubKey(fundingKeys[5]))})};
+        txs[0].sign(fundingKeys[5]);
+        for (size_t i = 1; i < kChain; ++i) txs.push_back(spendUnconfirmed(txs.back(), 5, 1000));
+        const PeerInfo peer("10.0.0.1", 8185);
+
+        QBENCHMARK_ONCE {
+            for (size_t i = kChain; i-- > 0;) chain.submitTransaction(txs[i], peer); // la racine arrive en dernier
+            const auto start = std::chrono::steady_clock::now();
+            while (chain.getTransactionPool().size() < kChain
+                   && std::chrono::steady_clock::now() - start < std::chrono::seconds(5)) {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        }
+        const auto stats = chain.getAdmissionStats();
+        qInfo() << "orphaned" << stats.orphaned << ", accepted with their parent" << stats.orphansAccepted
+                << ", left" << stats.orphans.count;
+    }
+
+    // Redémarrage : la pool est sauvegardée puis relue et revalidée, signatures en parallèle (contenu vérifié dans test_pool)
+    void mempoolPersistence() {
+        Blockchain chain;
+        fund(chain);
+        TransactionPool& pool = chain.getTransactionPool();
+        constexpr size_t kTxs = kFundedOutputs - 1;
+        for (size_t i = 0; i < kTxs; ++i) pool.addTransaction(spend(i, static_cast<Amount>(1000 + i)));
+        Transaction link({OutputReference(0, 0, kTxs)}, {Output(10 * COIN - 1000, crypto::getPubKey(fundingKeys[kTxs % 8]))});
+        link.sign(fundingKeys[kTxs % 8]);
+        pool.addTransaction(link);
+        for (size_t i = 0; i < 10; ++i) {
+            link = spendUnconfirmed(link, kTxs, 1000);
+            pool.addTransaction(link);
+        }
+
+        const std::string path = (std::filesystem::temp_directory_path() / "bench_mempool.dat").string();
+        QBENCHMARK_ONCE {
+            chain.saveMempool(path);
+        }
+        qInfo() << pool.size() << "transactions saved in" << std::filesystem::file_size(path) << "bytes";
+
+        // Chaîne déjà à jour : revalidation immédiate, signatures absentes du cache
+        SignatureCache::instance().clear();
+        Blockchain restarted;
+        fund(restarted);
+        QBENCHMARK_ONCE {
+            restarted.loadMempool(path);
+            restarted.drainAdmission();
+        }
+
+        // Référence : les mêmes transactions admises une par une, cache vide
+        SignatureCache::instance().clear();
+        const auto contents = MempoolFile::load(path);
+        QVERIFY(contents);
+        Blockchain sequential;
+        fund(sequential);
+        const auto start = std::chrono::steady_clock::now();
+        for (const auto& tx : contents->txs) sequential.getTransactionPool().addTransaction(tx);
+        qInfo() << "sequential admission:" << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() << "ms";
+        std::filesystem::remove(path);
+    }
+
+    // Modèle de bloc tenu à jour par la pool : lecture par le mineur après un bloc (contenu vérifié dans test_pool)
+    void blockTemplate() {
+        Blockchain chain;
+        fund(chain);
+        TransactionPool& pool = chain.getTransactionPool();
+        constexpr size_t kTxs = 200;
+        pool.setTemplateBytes(50 * spend(0, 0).getSize());
+        for (size_t i = 0; i < kTxs; ++i) pool.addTransaction(spend(i, static_cast<Amount>(1000 + 10 * i)));
+
+        std::atomic<bool> keepMining{true};
+        chain.addBlock(Block::createBlock(chain, owner, &keepMining, nullptr));
+        std::shared_ptr<const BlockTemplate> current;
+        QBENCHMARK {
+            current = pool.blockTemplate(); // déjà publié : chargement atomique seul
+        }
+        qInfo() << "template:" << current->entries.size() << "of" << pool.size() << "transactions," << current->bytes
+                << "bytes, rebuilt" << pool.getStats().templateRebuilds << "times";
+    }
+
+    // Connexion d'un bloc concurrent : retrait des transactions en conflit de la pool (comptes vérifiés dans test_pool)
+    void blockConflicts() {
+        Blockchain chain;
+        Blockchain other; // même bloc 0 : ses transactions concurrentes sont minées ailleurs
+        fund(chain);
+        fund(other);
+        TransactionPool& pool = chain.getTransactionPool();
+        constexpr size_t kPool = 200;
+        constexpr size_t kConflicts = 100;
+        for (size_t i = 0; i < kPool; ++i) pool.addTransaction(spend(i, 1000));
+        for (size_t i = 0; i < kConflicts; ++i) other.getTransactionPool().addTransaction(spend(i, 2000));
+
+        std::atomic<bool> keepMining{true};
+        const Block mined = Block::createBlock(other, owner, &keepMining, nullptr);
+        QBENCHMARK_ONCE {
+            chain.addBlock(mined);
+        }
+        qInfo() << "removed" << pool.getStats().conflicts << "conflicting transactions, kept" << pool.size();
+    }
+
+    // (Dé)sérialisation réseau d'un bloc et d'une transaction : flux std::stringstream contre archives sur buffer/span
+    void serializeBlockStream() {
+        const Block block = makeBlock();
+        std::vector<uint8_t> bytes;
+        QBENCHMARK {
+            bytes = serializeWithStream(block);
+        }
+        QVERIFY(bytes == BinaryProtocol::serializeObject(block)); // format identique
+    }
+    void serializeBlockSpan() {
+        const Block block = makeBlock();
+        size_t size = 0;
+        QBENCHMARK {
+            PooledBuffer payload;
+            BinaryProtocol::serializeInto(block, payload.get());
+            size = payload.bytes().size();
+        }
+        qInfo() << "block payload:" << size << "bytes";
+    }
+    void deserializeBlockStream() {
+        const std::vector<uint8_t> bytes = BinaryProtocol::serializeObject(makeBlock());
+        Block block;
+        QBENCHMARK {
+            block = deserializeWithStream<Block>(bytes);
+        }
+        QCOMPARE(block.getBlockTransactions().size(), signedTxs.size());
+    }
+    void deserializeBlockSpan() {
+        const std::vector<uint8_t> bytes = BinaryProtocol::serializeObject(makeBlock());
+        Block block;
+        QBENCHMARK {
+            block = BinaryProtocol::deserializeObject<Block>(bytes.data(), bytes.size());
+        }
+        QCOMPARE(block.getBlockTransactions().size(), signedTxs.size());
+    }
+    void serializeTxStream() {
+        std::vector<uint8_t> bytes;
+        QBENCHMARK {
+            bytes = serializeWithStream(signedTxs[0]);
+        }
+        QVERIFY(bytes == BinaryProtocol::serializeObject(signedTxs[0]));
+    }
+    void serializeTxSpan() {
+        size_t size = 0;
+        QBENCHMARK {
+            PooledBuffer payload;
+            BinaryProtocol::serializeInto(signedTxs[0], payload.get());
+            size = payload.bytes().size();
+        }
+        QVERIFY(size > 0);
+    }
+    void deserializeTxStream() {
+        const std::vector<uint8_t> bytes = BinaryProtocol::serializeObject(signedTxs[0]);
+        Transaction tx;
+        QBENCHMARK {
+            tx = deserializeWithStream<Transaction>(bytes);
+        }
+        QCOMPARE(tx.getTxid(), signedTxs[0].getTxid());
+    }
+    void deserializeTxSpan() {
+        const std::vector<uint8_t> bytes = BinaryProtocol::serializeObject(signedTxs[0]);
+        Transaction tx;
+        QBENCHMARK {
+            tx = BinaryProtocol::deserializeObject<Transaction>(bytes.data(), bytes.size());
+        }
+        QCOMPARE(tx.getTxid(), signedTxs[0].getTxid());
+        bool truncated = false;
+        try {
+            BinaryProtocol::deserializeObject<Transaction>(bytes.data(), bytes.size() - 1);
+        } catch (const cereal::Exception&) {
+            truncated = true;
+        }
+        QVERIFY(truncated);
+    }
+
+    // Protocole v3 (varints, inputs delta-encodés) contre v2 (entiers à taille fixe)
+    void compactPayloadSize() {
+        const Block block = makeBlock();
+        const auto fixedBlock = BinaryProtocol::serializeObject(block);
+        std::vector<uint8_t> compactBlock;
+        BinaryProtocol::serializeInto(block, compactBlock, COMPACT_PROTOCOL_VERSION);
+        qInfo() << "block:" << fixedBlock.size() << "->" << compactBlock.size() << "bytes ("
+                << (fixedBlock.size() - compactBlock.size()) / signedTxs.size() << "bytes saved per tx)";
+        QVERIFY(compactBlock.size() < fixedBlock.size());
+
+        // Le hash et les txids ne dépendent pas du format réseau
+        const Block decoded = BinaryProtocol::deserializeObject<Block>(compactBlock.data(), compactBlock.size(), COMPACT_PROTOCOL_VERSION);
+        QCOMPARE(decoded.getHash(), block.getHash());
+        QCOMPARE(decoded.getBlockTransactions().getMerkleRoot(), block.getBlockTransactions().getMerkleRoot());
+
+        // Transaction de 20 inputs pris dans des blocs proches (delta-encodage des index de bloc)
+        Inputs inputs;
+        for (uint32_t i = 0; i < 20; ++i) inputs.emplace_back(150000 + 3 * i, static_cast<uint16_t>(i % 4), 1);
+        Transaction tx(inputs, {Output(5 * COIN, owner), Output(COIN / 3, owner)});
+        const auto fixedTx = BinaryProtocol::serializeObject(tx);
+        std::vector<uint8_t> compactTx;
+        BinaryProtocol::serializeInto(tx, compactTx, COMPACT_PROTOCOL_VERSION);
+        qInfo() << "20-input tx:" << fixedTx.size() << "->" << compactTx.size() << "bytes";
+        const Transaction decodedTx = BinaryProtocol::deserializeObject<Transaction>(compactTx.data(), compactTx.size(), COMPACT_PROTOCOL_VERSION);
+        QCOMPARE(decodedTx.getTxid(), tx.getTxid());
+    }
+    void serializeBlockCompact() {
+        const Block block = makeBlock();
+        QBENCHMARK {
+            PooledBuffer payload;
+            BinaryProtocol::serializeInto(block, payload.get(), COMPACT_PROTOCOL_VERSION);
+        }
+    }
+    void deserializeBlockCompact() {
+        std::vector<uint8_t> bytes;
+        BinaryProtocol::serializeInto(makeBlock(), bytes, COMPACT_PROTOCOL_VERSION);
+        Block block;
+        QBENCHMARK {
+            block = BinaryProtocol::deserializeObject<Block>(bytes.data(), bytes.size(), COMPACT_PROTOCOL_VERSION);
+        }
+        QCOMPARE(block.getBlockTransactions().size(), signedTxs.size());
+    }
+    // Inputs d'une transaction maximale : 3 appels par référence contre un memcpy pour tout le vecteur
+    void inputsFieldwise() {
+        std::vector<FieldwiseRef> refs;
+        for (uint32_t i = 0; i < MAX_INPUTS; ++i) refs.push_back({i * 17, static_cast<uint16_t>(i % 11), static_cast<uint16_t>(i % 3)});
+        std::vector<uint8_t> bytes;
+        QBENCHMARK {
+            bytes.clear();
+            cereal::ByteOutputArchive ar(bytes);
+            ar(refs);
+        }
+        std::vector<FieldwiseRef> decoded;
+        QBENCHMARK {
+            cereal::SpanInputArchive ar(bytes);
+            ar(decoded);
+        }
+        QCOMPARE(decoded.size(), refs.size());
+    }
+    void inputsBulk() {
+        Inputs refs;
+        for (uint32_t i = 0; i < MAX_INPUTS; ++i) refs.emplace_back(i * 17, static_cast<uint16_t>(i % 11), static_cast<uint16_t>(i % 3));
+        std::vector<uint8_t> bytes;
+        QBENCHMARK {
+            bytes.clear();
+            cereal::ByteOutputArchive ar(bytes);
+            ar(refs);
+        }
+        Inputs decoded;
+        {
+            cereal::SpanInputArchive ar(bytes);
+            ar(decoded);
+        }
+        QVERIFY(std::equal(refs.begin(), refs.end(), decoded.begin(), decoded.end(),
+                           [](const auto& a, const auto& b) { return !(a < b) && !(b < a); }));
+
+        // Octets identiques au chemin champ par champ (format réseau inchangé)
+        std::vector<FieldwiseRef> fieldwise;
+        for (const auto& ref : refs) fieldwise.push_back({ref.getBlockIndex(), ref.getTxIndex(), ref.getOutputIndex()});
+        QVERIFY(bytes == BinaryProtocol::serializeObject(fieldwise));
+        QVERIFY(bytes == serializeWithStream(refs));
+
+        // Taille annoncée plus grande que le payload : refusée avant l'allocation
+        bytes.resize(bytes.size() - 1);
+        bool rejected = false;
+        try {
+            cereal::SpanInputArchive ar(bytes);
+            ar(decoded);
+        } catch (const cereal::Exception&) {
+            rejected = true;
+        }
+        QVERIFY(rejected);
+    }
+
+    // Mémoire des clés propriétaires pour une chaîne de 5 millions de sorties et 200 000 propriétaires
+    void ownerInterningMemory() {
+        constexpr size_t kOutputs = 5000000;
+        constexpr size_t kOwners = 200000;
+
+        OwnerTable table;
+        std::mt19937_64 rng(7);
+        for (size_t i = 0; i < kOwners; ++i) {
+            PubKey key;
+            for (auto& b : key.bytes) b = static_cast<uint8_t>(rng());
+            table.intern(key);
+        }
+        QCOMPARE(table.size(), kOwners + 1);
+
+        // UTXOs et WalletIndex : une copie de la clé (ancien) ou un identifiant (nouveau) ; Output garde sa clé (rien n'est interné au décodage)
+        struct OutputWithKey { double value; PubKey pubKey; };
+        const size_t oldOutputs = kOutputs * sizeof(OutputWithKey);
+        const size_t newOutputs = kOutputs * sizeof(Output);
+        const size_t oldIndexKeys = 2 * kOwners * sizeof(PubKey);
+        const size_t newIndexKeys = 2 * kOwners * sizeof(OwnerId) + table.memoryUsage();
+
+        const double mb = 1024.0 * 1024.0;
+        qInfo() << "outputs:" << oldOutputs / mb << "->" << newOutputs / mb << "MB ("
+                << sizeof(OutputWithKey) << "->" << sizeof(Output) << "bytes each)";
+        qInfo() << "UTXO + wallet index keys (incl. owner table):" << oldIndexKeys / mb << "->" << newIndexKeys / mb << "MB";
+        qInfo() << "total:" << (oldOutputs + oldIndexKeys) / mb << "->" << (newOutputs + newIndexKeys) / mb << "MB";
+    }
+
+    // Validation d'un bloc dont les transactions ont déjà été vues par le mempool
+    void blockSignaturesAfterMempool() {
+        SignatureCache& cache = SignatureCache::instance();
+        cache.clear();
+        for (size_t i = 0; i < signedTxs.size(); ++i) { // passage dans le mempool : miss + insertion
+            QVERIFY(signedTxs[i].verifySignature(signers[i]));
+        }
+        bool ok = true;
+        QBENCHMARK {
+            for (size_t i = 0; i < signedTxs.size() && ok; ++i) {
+                ok = signedTxs[i].verifySignature(signers[i]);
+            }
+        }
+        QVERIFY(ok);
+        const auto stats = cache.getStats();
+        qInfo() << "SignatureCache hits:" << stats.hits << "misses:" << stats.misses
+                << "hit rate:" << stats.hitRate() << "entries:" << stats.size;
+        QCOMPARE(stats.misses, static_cast<uint64_t>(signedTxs.size()));
+    }
+};
+
+QTEST_APPLESS_MAIN(BenchBlockchain)
+#include "bench_blockchain.moc"
@@ -0,0 +1,508 @@
+#include <QtTest/QtTest>
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <cereal/archives/binary.hpp>
+#include <openssl/bn.h>
+#include <openssl/ec.h>
+
+#include "transaction/Transaction.hpp"
+#include "transaction/BlockTransactions.hpp"
+#include "transaction/TransactionPool.hpp"
+#include "transaction/MempoolFile.hpp"
+#include "network/BinaryProtocol.hpp"
+#include "network/OrphanPool.hpp"
+#include "Block.hpp"
+#include "Blockchain.hpp"
+
+// Comportement de la pool de transactions sur une vraie chaîne (les temps sont mesurés dans bench_blockchain)
+class TestPool : public QObject {
+    Q_OBJECT
+
+    // BlockTransactions n'a pas de constructeur public depuis un vecteur : même format binaire que ar(txs)
+    static BlockTransactions loadBlockTransactions(const std::vector<Transaction>& txs) {
+        std::stringstream ss(std::ios::in | std::ios::out | std::ios::binary);
+        {
+            cereal::BinaryOutputArchive ar(ss);
+            ar(txs);
+        }
+        BlockTransactions loaded;
+        {
+            cereal::BinaryInputArchive ar(ss);
+            ar(loaded);
+        }
+        return loaded;
+    }
+
+    // Bloc 0 (accepté sans preuve de travail) dont l'unique transaction crée les sorties données
+    static Block makeGenesis(const Outputs& outputs) {
+        std::vector<uint8_t> bytes;
+        {
+            cereal::ByteOutputArchive ar(bytes);
+            ar(uint32_t{0}, uint32_t{0}, uint32_t{1700000000}, Target::createInitialTarget(),
+               loadBlockTransactions({Transaction({}, outputs)}), Hash{}, crypto::hashData("genesis"));
+        }
+        return BinaryProtocol::deserializeObject<Block>(bytes.data(), bytes.size());
+    }
+
+    // Point générateur G de secp256k1 (clé publique valide quelconque)
+    PubKey owner = PubKey::fromHex("0279be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798");
+
+    // Le bloc 0 crée kFundedOutputs sorties de 10 SKBC, la sortie i appartient à fundingKeys[i % 8]
+    static constexpr size_t kFundedOutputs = 400;
+    std::vector<EVP_PKEY*> fundingKeys;
+
+    void fund(Blockchain& chain) const {
+        Outputs funding;
+        for (size_t i = 0; i < kFundedOutputs; ++i) funding.emplace_back(10 * COIN, crypto::getPubKey(fundingKeys[i % 8]));
+        QVERIFY(chain.addBlock(makeGenesis(funding)));
+    }
+    /*Dépense la sortie financée donnée vers owner en laissant fee de frais*/
+    Transaction spend(size_t output, Amount fee) const {
+        Transaction tx({OutputReference(0, 0, static_cast<uint16_t>(output))}, {Output(10 * COIN - fee, owner)});
+        tx.sign(fundingKeys[output % 8]);
+        return tx;
+    }
+    /*Dépense la première sortie de parent, encore non confirmé, vers fundingKeys[key % 8]*/
+    Transaction spendUnconfirmed(const Transaction& parent, size_t key, Amount fee) const {
+        Transaction child({OutputReference(OutputReference::UNCONFIRMED, 0, 0)},
+                          {Output(parent.getOutputs()[0].getValue() - fee, crypto::getPubKey(fundingKeys[key % 8]))},
+                          {parent.getTxid()});
+        child.sign(fundingKeys[key % 8]);
+        return child;
+    }
+
+private slots:
+    void initTestCase() {
+        for (int k = 0; k < 8; ++k) fundingKeys.push_back(crypto::createPrivateKey());
+    }
+    void cleanupTestCase() {
+        for (EVP_PKEY* key : fundingKeys) EVP_PKEY_free(key);
+    }
+
+    // Afflux de transactions : la pool reste sous sa limite mémoire en évinçant les moins bien payées
+    void memoryCap() {
+        Blockchain chain;
+        fund(chain);
+        TransactionPool& pool = chain.getTransactionPool();
+        constexpr size_t kFlood = 300;
+        std::vector<Transaction> flood;
+        for (size_t i = 0; i < kFlood; ++i) {
+            flood.push_back(spend(i, static_cast<Amount>(1000 * (1 + i % 50))));
+            QVERIFY(pool.addTransaction(flood.back()));
+        }
+        pool.setMaxMemory(pool.getStats().memoryUsage / 3);
+        const auto trimmed = pool.getStats();
+        QVERIFY(trimmed.memoryUsage <= trimmed.maxMemory);
+        QCOMPARE(trimmed.count + trimmed.evicted, uint64_t{kFlood});
+        QVERIFY(trimmed.minFeePerKB > 0.0);
+
+        // Les conservées sont celles qui payent le plus
+        const auto view = pool.snapshot();
+        const double lowestKeptPerKB = static_cast<double>(view->byFeeRate.back()->rate.fee) * 1000.0 / view->byFeeRate.back()->rate.size;
+        QVERIFY(lowestKeptPerKB + TransactionPool::kMinFeeIncrementPerKB >= trimmed.minFeePerKB);
+
+        // Frais nuls (sendTransaction de l'UI) : refusée tant que la pression dure
+        QVERIFY(!pool.addTransaction(spend(kFlood, 0)));
+        QCOMPARE(pool.getStats().rejectedLowFee, uint64_t{1});
+
+        // La sortie d'une évincée est libérée : une transaction mieux payée peut la dépenser
+        size_t evictedOutput = 1;
+        while (pool.contains(flood[evictedOutput].getTxid())) ++evictedOutput;
+        QVERIFY(pool.addTransaction(spend(evictedOutput, 100 * 1000)));
+        QVERIFY(!pool.addTransaction(spend(kFlood - 1, 100 * 1000))); // sortie d'une conservée : conflit
+    }
+
+    // Éviction par score de descendants : un parent sans frais payé par son enfant (CPFP) n'est pas évincé avec lui
+    void evictionKeepsPaidParents() {
+        Blockchain chain;
+        fund(chain);
+        TransactionPool& pool = chain.getTransactionPool();
+        Transaction parent({OutputReference(0, 0, 0)}, {Output(10 * COIN, crypto::getPubKey(fundingKeys[0]))});
+        parent.sign(fundingKeys[0]);
+        const Transaction child = spendUnconfirmed(parent, 0, 200000);
+        QVERIFY(pool.addTransaction(parent));
+        QVERIFY(pool.addTransaction(child));
+
+        constexpr size_t kFlood = 300;
+        for (size_t i = 1; i <= kFlood; ++i) QVERIFY(pool.addTransaction(spend(i, static_cast<Amount>(1000 * (1 + i % 50)))));
+        pool.setMaxMemory(pool.getStats().memoryUsage / 3);
+        QVERIFY(pool.getStats().evicted > 0);
+        QVERIFY(pool.contains(parent.getTxid()));
+        QVERIFY(pool.contains(child.getTxid()));
+    }
+
+    // Chaînes non confirmées : un enfant bien payé fait passer son parent (CPFP), dans le même bloc et après lui
+    void chainedTransactions() {
+        Blockchain chain;
+        fund(chain);
+        TransactionPool& pool = chain.getTransactionPool();
+        Transaction parent({OutputReference(0, 0, 0)}, {Output(10 * COIN - 100, crypto::getPubKey(fundingKeys[0]))});
+        parent.sign(fundingKeys[0]);
+        const Transaction child = spendUnconfirmed(parent, 0, 200000);
+
+        QVERIFY(!pool.addTransaction(child)); // parent inconnu
+        for (uint8_t version : {MIN_PROTOCOL_VERSION, PROTOCOL_VERSION}) {
+            std::vector<uint8_t> bytes;
+            BinaryProtocol::serializeInto(child, bytes, version);
+            QCOMPARE(BinaryProtocol::deserializeObject<Transaction>(bytes.data(), bytes.size(), version).getTxid(), child.getTxid());
+        }
+        for (size_t i = 1; i <= 20; ++i) QVERIFY(pool.addTransaction(spend(i, 5000)));
+        QVERIFY(pool.addTransaction(parent));
+        QCOMPARE(pool.selectForBlock(MAX_BLOCK_BYTES).back()->tx.getTxid(), parent.getTxid()); // seule, la moins bien payée
+
+        QVERIFY(pool.addTransaction(child));
+        QVERIFY(!pool.addTransaction(spendUnconfirmed(parent, 0, 300000))); // même sortie non confirmée : conflit
+        const auto selected = pool.selectForBlock(MAX_BLOCK_BYTES);
+        QCOMPARE(selected[0]->tx.getTxid(), parent.getTxid());
+        QCOMPARE(selected[1]->tx.getTxid(), child.getTxid());
+
+        // Longue chaîne : bornée à kMaxAncestors transactions
+        Transaction link({OutputReference(0, 0, 300)}, {Output(10 * COIN - 1000, crypto::getPubKey(fundingKeys[300 % 8]))});
+        link.sign(fundingKeys[300 % 8]);
+        QVERIFY(pool.addTransaction(link));
+        size_t length = 1;
+        for (; length < 30; ++length) {
+            link = spendUnconfirmed(link, 300, 1000);
+            if (!pool.addTransaction(link)) break;
+        }
+        QCOMPARE(length, size_t{TransactionPool::kMaxAncestors});
+        QCOMPARE(pool.getStats().rejectedPackage, uint64_t{1});
+        QCOMPARE(pool.selectForBlock(MAX_BLOCK_BYTES).size(), pool.size());
+
+        // Bloc miné : parents et enfants confirmés ensemble, la pool est vidée
+        std::atomic<bool> keepMining{true};
+        QVERIFY(chain.addBlock(Block::createBlock(chain, owner, &keepMining, nullptr)));
+        QCOMPARE(pool.size(), size_t{0});
+        const auto parentAt = chain.findTransaction(parent.getTxid());
+        const auto childAt = chain.findTransaction(child.getTxid());
+        QVERIFY(parentAt && childAt);
+        QCOMPARE(childAt->blockIndex, uint32_t{1});
+        QVERIFY(parentAt->txIndex < childAt->txIndex);
+        const auto& childOwnerUtxos = chain.getUTXOs().at(*OwnerTable::instance().find(child.getOutputs()[0].getPubKey()));
+        QVERIFY(childOwnerUtxos.count(OutputReference(1, childAt->txIndex, 0)) == 1);
+        QVERIFY(childOwnerUtxos.count(OutputReference(0, 0, 0)) == 0);
+    }
+
+    // Chaîne reçue dans le désordre : les enfants attendent leur parent dans l'OrphanPool au lieu d'être perdus
+    void orphanTransactions() {
+        Blockchain chain;
+        fund(chain);
+        constexpr size_t kChain = 10;
+        std::vector<Transaction> txs{Transaction({OutputReference(0, 0, 5)}, {Output(10 * COIN - 1000, crypto::getPubKey(fundingKeys[5]))})};
+        txs[0].sign(fundingKeys[5]);
+        for (size_t i = 1; i < kChain; ++i) txs.push_back(spendUnconfirmed(txs.back(), 5, 1000));
+        const PeerInfo peer("10.0.0.1", 8185);
+
+        for (size_t i = kChain; i-- > 0;) chain.submitTransaction(txs[i], peer); // la racine arrive en dernier
+        const auto start = std::chrono::steady_clock::now();
+        while (chain.getTransactionPool().size() < kChain
+               && std::chrono::steady_clock::now() - start < std::chrono::seconds(5)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        const auto stats = chain.getAdmissionStats();
+        QCOMPARE(chain.getTransactionPool().size(), kChain);
+        QCOMPARE(stats.orphaned, uint64_t{kChain - 1});
+        QCOMPARE(stats.orphansAccepted, uint64_t{kChain - 1});
+        QCOMPARE(stats.orphans.count, size_t{0});
+
+        // Limites : par pair, total (plus ancienne retirée) et durée de vie
+        OrphanPool orphans;
+        auto fake = [this](size_t i) {
+            return Transaction({OutputReference(OutputReference::UNCONFIRMED, 0, 0)}, {Output(COIN, owner)},
+                               {crypto::hashData("missing parent " + std::to_string(i))});
+        };
+        const auto now = OrphanPool::Clock::now();
+        size_t stored = 0;
+        for (size_t i = 0; i < 2 * OrphanPool::kMaxPerPeer; ++i) stored += orphans.add(fake(i), peer, now);
+        QCOMPARE(stored, OrphanPool::kMaxPerPeer);
+        for (size_t i = 0; i < 2 * OrphanPool::kMaxOrphans; ++i) {
+            orphans.add(fake(1000 + i), PeerInfo("10.0.1." + std::to_string(i), 8185), now + std::chrono::seconds(i));
+        }
+        QCOMPARE(orphans.size(), OrphanPool::kMaxOrphans);
+        QVERIFY(!orphans.contains(fake(0).getTxid()));
+        QVERIFY(orphans.contains(fake(1000 + 2 * OrphanPool::kMaxOrphans - 1).getTxid()));
+        QVERIFY(!orphans.add(spend(0, 1000), peer, now)); // aucun parent non confirmé
+        QVERIFY(orphans.add(fake(5000), peer, now + OrphanPool::kExpiry + std::chrono::hours(1)));
+        QCOMPARE(orphans.size(), size_t{1});
+        QCOMPARE(orphans.getStats().expired, uint64_t{OrphanPool::kMaxOrphans});
+    }
+
+    // Redémarrage : la pool sauvegardée est relue et revalidée, tout de suite ou dès que la chaîne a rattrapé la sauvegarde
+    void mempoolPersistence() {
+        Blockchain chain;
+        fund(chain);
+        TransactionPool& pool = chain.getTransactionPool();
+        constexpr size_t kTxs = 50;
+        for (size_t i = 0; i < kTxs; ++i) QVERIFY(pool.addTransaction(spend(i, static_cast<Amount>(1000 + i))));
+        Transaction link({OutputReference(0, 0, kTxs)}, {Output(10 * COIN - 1000, crypto::getPubKey(fundingKeys[kTxs % 8]))});
+        link.sign(fundingKeys[kTxs % 8]);
+        QVERIFY(pool.addTransaction(link));
+        for (size_t i = 0; i < 10; ++i) {
+            link = spendUnconfirmed(link, kTxs, 1000);
+            QVERIFY(pool.addTransaction(link));
+        }
+        const size_t saved = pool.size();
+        const std::string path = (std::filesystem::temp_directory_path() / "test_mempool.dat").string();
+        QVERIFY(chain.saveMempool(path));
+        const auto contents = MempoolFile::load(path);
+        QVERIFY(contents && contents->height == 1);
+        QCOMPARE(contents->tip, chain[0].getHash());
+        QCOMPARE(contents->txs.size(), saved);
+
+        // Chaîne déjà à jour : revalidation immédiate
+        Blockchain restarted;
+        fund(restarted);
+        QVERIFY(restarted.loadMempool(path));
+        restarted.drainAdmission();
+        QCOMPARE(restarted.getTransactionPool().size(), saved);
+        QCOMPARE(restarted.getTransactionPool().getStats().chained, size_t{10});
+
+        // Chaîne pas encore synchronisée : la pool attend que le bloc de la sauvegarde soit connecté
+        Blockchain syncing;
+        QVERIFY(syncing.loadMempool(path));
+        syncing.drainAdmission();
+        QCOMPARE(syncing.getTransactionPool().size(), size_t{0});
+        fund(syncing);
+        syncing.drainAdmission();
+        QCOMPARE(syncing.getTransactionPool().size(), saved);
+
+        // Même hauteur sur une autre chaîne (bloc 1 miné par un autre) : la sauvegarde est écartée
+        std::atomic<bool> keepMining{true};
+        QVERIFY(chain.addBlock(Block::createBlock(chain, owner, &keepMining, nullptr)));
+        QVERIFY(pool.addTransaction(spend(kTxs + 1, 1000)));
+        QVERIFY(chain.saveMempool(path));
+        Blockchain forked;
+        fund(forked);
+        QVERIFY(forked.addBlock(Block::createBlock(forked, crypto::getPubKey(fundingKeys[0]), &keepMining, nullptr)));
+        QVERIFY(forked.loadMempool(path));
+        forked.drainAdmission();
+        QCOMPARE(forked.getTransactionPool().size(), size_t{0});
+
+        // Fichier tronqué : ignoré
+        std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+        QVERIFY(!Blockchain().loadMempool(path));
+        std::filesystem::remove(path);
+    }
+
+    // Modèle de bloc tenu à jour par la pool : le mineur le reprend tel quel après un bloc
+    void blockTemplate() {
+        Blockchain chain;
+        fund(chain);
+        TransactionPool& pool = chain.getTransactionPool();
+        constexpr size_t kTxs = 200;
+        constexpr size_t kPerBlock = 50;
+        const size_t templateBytes = kPerBlock * spend(0, 0).getSize();
+        pool.setTemplateBytes(templateBytes);
+        auto sameTxids = [](const std::vector<std::shared_ptr<const PoolEntry>>& a, const std::vector<std::shared_ptr<const PoolEntry>>& b) {
+            std::set<Hash> x, y;
+            for (const auto& entry : a) x.insert(entry->tx.getTxid());
+            for (const auto& entry : b) y.insert(entry->tx.getTxid());
+            return a.size() == b.size() && x == y;
+        };
+
+        for (size_t i = 0; i < kTxs; ++i) QVERIFY(pool.addTransaction(spend(i, static_cast<Amount>(1000 + 10 * i))));
+        auto current = pool.blockTemplate();
+        QVERIFY(current->bytes <= templateBytes && current->entries.size() + 1 >= kPerBlock); // signatures DER : tailles à un octet près
+        QVERIFY(sameTxids(current->entries, pool.selectForBlock(templateBytes)));
+        Amount fees = 0;
+        for (const auto& entry : current->entries) fees += entry->rate.fee;
+        QCOMPARE(current->fees, fees);
+        const uint64_t rebuilds = pool.getStats().templateRebuilds;
+
+        // Moins bien payée que le modèle plein : il reste inchangé
+        QVERIFY(pool.addTransaction(spend(kTxs, 1)));
+        QVERIFY(pool.blockTemplate() == current);
+
+        // Enfant qui paye pour son parent (CPFP) : le modèle est refait, parent avant enfant
+        Transaction parent({OutputReference(0, 0, 300)}, {Output(10 * COIN - 1, crypto::getPubKey(fundingKeys[300 % 8]))});
+        parent.sign(fundingKeys[300 % 8]);
+        const Transaction child = spendUnconfirmed(parent, 300, 500000);
+        QVERIFY(pool.addTransaction(parent));
+        QVERIFY(pool.addTransaction(child));
+        current = pool.blockTemplate();
+        QCOMPARE(pool.getStats().templateRebuilds, rebuilds + 1);
+        QVERIFY(sameTxids(current->entries, pool.selectForBlock(templateBytes)));
+        QCOMPARE(current->entries[0]->tx.getTxid(), parent.getTxid());
+        QCOMPARE(current->entries[1]->tx.getTxid(), child.getTxid());
+
+        // Bloc miné : ses transactions quittent le modèle, la place est comblée pendant la connexion du bloc
+        std::atomic<bool> keepMining{true};
+        const Block mined = Block::createBlock(chain, owner, &keepMining, nullptr);
+        QCOMPARE(mined.getBlockTransactions().size(), current->entries.size() + 1);
+        QVERIFY(chain.addBlock(mined));
+        current = pool.blockTemplate();
+        QVERIFY(current == pool.blockTemplate()); // déjà publié : même modèle
+        QVERIFY(current->bytes <= templateBytes && current->entries.size() + 1 >= kPerBlock);
+        QVERIFY(sameTxids(current->entries, pool.selectForBlock(templateBytes)));
+        QCOMPARE(pool.getStats().templateRebuilds, rebuilds + 1); // comblé, pas refait
+    }
+
+    // Bloc qui dépense autrement des sorties déjà dépensées dans la pool : les transactions en conflit et leurs descendants partent
+    void blockConflicts() {
+        Blockchain chain;
+        Blockchain other; // même bloc 0 : ses transactions concurrentes sont minées ailleurs
+        fund(chain);
+        fund(other);
+        TransactionPool& pool = chain.getTransactionPool();
+        constexpr size_t kPool = 200;
+        constexpr size_t kConflicts = 100;
+        for (size_t i = 0; i < kPool; ++i) QVERIFY(pool.addTransaction(spend(i, 1000)));
+        for (size_t i = 0; i < kConflicts; ++i) QVERIFY(other.getTransactionPool().addTransaction(spend(i, 2000)));
+
+        // Deux sorties dépensées ensemble, dont une seule par le bloc concurrent ; un enfant en dépend
+        Transaction pair({OutputReference(0, 0, kPool), OutputReference(0, 0, kPool + 8)},
+                         {Output(20 * COIN - 1000, crypto::getPubKey(fundingKeys[0]))});
+        pair.sign(fundingKeys[0]);
+        const Transaction child = spendUnconfirmed(pair, 0, 1000);
+        QVERIFY(pool.addTransaction(pair));
+        QVERIFY(pool.addTransaction(child));
+        QVERIFY(other.getTransactionPool().addTransaction(spend(kPool, 2000)));
+
+        std::atomic<bool> keepMining{true};
+        const Block mined = Block::createBlock(other, owner, &keepMining, nullptr);
+        QCOMPARE(mined.getBlockTransactions().size(), kConflicts + 2);
+        QVERIFY(chain.addBlock(mined));
+        QCOMPARE(pool.getStats().conflicts, uint64_t{kConflicts + 2});
+        QCOMPARE(pool.size(), kPool - kConflicts);
+        QVERIFY(!pool.contains(pair.getTxid()) && !pool.contains(child.getTxid()));
+        for (const auto& entry : pool.blockTemplate()->entries) QVERIFY(!(entry->tx.getTxid() == child.getTxid()));
+
+        // L'autre sortie de la transaction retirée est de nouveau libre
+        QVERIFY(pool.addTransaction(spend(kPool + 8, 1000)));
+    }
+
+    // Deux récompenses de minage identiques (même mineur, même montant, sans frais) : txids distincts, dépensables ensemble
+    void identicalRewards() {
+        Blockchain chain;
+        fund(chain);
+        const PubKey miner = crypto::getPubKey(fundingKeys[0]);
+        std::atomic<bool> keepMining{true};
+        QVERIFY(chain.addBlock(Block::createBlock(chain, miner, &keepMining, nullptr)));
+        QVERIFY(chain.addBlock(Block::createBlock(chain, miner, &keepMining, nullptr)));
+        const Transaction& first = chain[1][0];
+        const Transaction& second = chain[2][0];
+        QCOMPARE(first.getOutputs()[0].getValue(), second.getOutputs()[0].getValue());
+        QVERIFY(first.getTxid() != second.getTxid());
+        QCOMPARE(chain.findTransaction(second.getTxid())->blockIndex, uint32_t{2});
+
+        // Hauteur engagée : la récompense d'un autre bloc est refusée
+        QVERIFY(!first.verifyMiningReward(chain, chain[2]));
+
+        TransactionPool& pool = chain.getTransactionPool();
+        const Amount reward = first.getOutputs()[0].getValue();
+        Transaction spendFirst({OutputReference(1, 0, 0)}, {Output(reward - 1000, owner)});
+        spendFirst.sign(fundingKeys[0]);
+        Transaction spendSecond({OutputReference(2, 0, 0)}, {Output(reward - 1000, owner)});
+        spendSecond.sign(fundingKeys[0]);
+        QVERIFY(pool.addTransaction(spendFirst));
+        QVERIFY(pool.addTransaction(spendSecond)); // pas de conflit sur un txid partagé
+        QVERIFY(chain.addBlock(Block::createBlock(chain, owner, &keepMining, nullptr)));
+        QCOMPARE(pool.size(), size_t{0});
+        QCOMPARE(chain.getWalletUtxoCount(miner), uint32_t{kFundedOutputs / 8});
+
+        // Un input COINBASE hors récompense ne dépense rien : refusé
+        Transaction forged({OutputReference(3, OutputReference::COINBASE, 0)}, {Output(COIN, owner)});
+        forged.sign(fundingKeys[0]);
+        QVERIFY(!pool.addTransaction(forged));
+    }
+
+    // Signature (r, n - s) : valide pour ECDSA mais autre txid, les enfants référençant le parent seraient orphelins
+    void malleatedSignature() {
+        Blockchain chain;
+        fund(chain);
+        const Transaction parent = spend(0, 1000);
+        const auto& der = parent.getSignature();
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(der.data());
+        ECDSA_SIG* sig = d2i_ECDSA_SIG(nullptr, &p, static_cast<long>(der.size()));
+        QVERIFY(sig);
+        BIGNUM* order = nullptr;
+        BN_hex2bn(&order, "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD0364141");
+        BIGNUM* highS = BN_new();
+        BN_sub(highS, order, ECDSA_SIG_get0_s(sig));
+        QVERIFY(BN_cmp(highS, ECDSA_SIG_get0_s(sig)) > 0); // signData produit la forme basse
+        ECDSA_SIG_set0(sig, BN_dup(ECDSA_SIG_get0_r(sig)), highS);
+        unsigned char buffer[crypto::MAX_SIGNATURE_SIZE];
+        unsigned char* out = buffer;
+        const int len = i2d_ECDSA_SIG(sig, &out);
+        ECDSA_SIG_free(sig);
+        BN_free(order);
+        const Signature malleated(reinterpret_cast<const char*>(buffer), static_cast<size_t>(len));
+
+        // Même encodage que Transaction::serialize (pas de parents), seule la signature change
+        std::vector<uint8_t> bytes;
+        {
+            cereal::ByteOutputArchive ar(bytes);
+            ar(parent.getInputs(), parent.getOutputs(), malleated);
+        }
+        const Transaction copy = BinaryProtocol::deserializeObject<Transaction>(bytes.data(), bytes.size());
+        QCOMPARE(copy.getSigHash(), parent.getSigHash());
+        QVERIFY(copy.getTxid() != parent.getTxid());
+        QVERIFY(!copy.verifySignature(crypto::getPubKey(fundingKeys[0])));
+        QVERIFY(!chain.getTransactionPool().addTransaction(copy));
+        QVERIFY(chain.getTransactionPool().addTransaction(parent));
+    }
+
+    // Transactions de pairs admises pendant qu'un bloc concurrent est connecté : aucune ne reste en conflit avec lui
+    void admissionDuringBlock() {
+        Blockchain chain;
+        Blockchain other;
+        fund(chain);
+        fund(other);
+        constexpr size_t kTxs = 200;
+        constexpr size_t kConflicts = 100;
+        for (size_t i = 0; i < kConflicts; ++i) QVERIFY(other.getTransactionPool().addTransaction(spend(i, 2000)));
+        std::atomic<bool> keepMining{true};
+        const Block mined = Block::createBlock(other, owner, &keepMining, nullptr);
+
+        std::vector<Transaction> txs;
+        for (size_t i = 0; i < kTxs; ++i) txs.push_back(spend(i, 1000));
+        const PeerInfo peer("10.0.0.1", 8185);
+        std::thread submitter([&] {
+            for (const auto& tx : txs) chain.submitTransaction(tx, peer);
+        });
+        QVERIFY(chain.addBlock(mined));
+        submitter.join();
+        const auto start = std::chrono::steady_clock::now();
+        while (chain.getAdmissionStats().depth > 0 && std::chrono::steady_clock::now() - start < std::chrono::seconds(5)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        // Les dépenses des sorties du bloc sont refusées ou retirées, les autres acceptées
+        TransactionPool& pool = chain.getTransactionPool();
+        QCOMPARE(pool.size(), kTxs - kConflicts);
+        for (size_t i = 0; i < kConflicts; ++i) QVERIFY(!pool.contains(txs[i].getTxid()));
+        QVERIFY(chain.addBlock(Block::createBlock(chain, owner, &keepMining, nullptr)));
+        QCOMPARE(pool.size(), size_t{0});
+    }
+
+    // Clés reçues d'un pair dans une transaction refusée : décodées et vérifiées sans entrer dans l'OwnerTable (jamais libérée)
+    void rejectedKeysNotInterned() {
+        Blockchain chain;
+        fund(chain);
+        Outputs outputs;
+        for (size_t i = 0; i < MAX_OUTPUTS; ++i) {
+            EVP_PKEY* key = crypto::createPrivateKey();
+            outputs.emplace_back(COIN / 100, crypto::getPubKey(key));
+            EVP_PKEY_free(key);
+        }
+        Transaction tx({OutputReference(0, 0, 0)}, outputs);
+        tx.sign(fundingKeys[1]); // sortie de fundingKeys[0] : signature invalide
+        std::vector<uint8_t> bytes;
+        BinaryProtocol::serializeInto(tx, bytes);
+
+        const size_t owners = OwnerTable::instance().size();
+        const Transaction received = BinaryProtocol::deserializeObject<Transaction>(bytes.data(), bytes.size());
+        QVERIFY(!chain.getTransactionPool().addTransaction(received));
+        QCOMPARE(OwnerTable::instance().size(), owners);
+    }
+};
+
+QTEST_APPLESS_MAIN(TestPool)
+#include "test_pool.moc"
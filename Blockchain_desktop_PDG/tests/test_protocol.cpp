@@ -0,0 +1,102 @@
+#include <QtTest/QtTest>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <cereal/archives/binary.hpp>
+
+#include "cryptography/crypto.hpp"
+#include "transaction/Transaction.hpp"
+#include "transaction/BlockTransactions.hpp"
+#include "network/CompactArchive.hpp"
+
+// Encodages reçus des pairs : clés compressées, racine de Merkle, archives compactes (les tailles et les temps sont mesurés dans bench_blockchain)
+class TestProtocol : public QObject {
+    Q_OBJECT
+
+    // BlockTransactions n'a pas de constructeur public depuis un vecteur : même format binaire que ar(txs)
+    static BlockTransactions loadBlockTransactions(const std::vector<Transaction>& txs) {
+        std::stringstream ss(std::ios::in | std::ios::out | std::ios::binary);
+        {
+            cereal::BinaryOutputArchive ar(ss);
+            ar(txs);
+        }
+        BlockTransactions loaded;
+        {
+            cereal::BinaryInputArchive ar(ss);
+            ar(loaded);
+        }
+        return loaded;
+    }
+
+private slots:
+    // Clé compressée : aller-retour getPubKey -> decodePubKey -> vérification, rejet des points invalides
+    void pubKeyCompressedRoundTrip() {
+        EVP_PKEY* key = crypto::createPrivateKey();
+        const PubKey pubKey = crypto::getPubKey(key);
+        QVERIFY(pubKey[0] == 0x02 || pubKey[0] == 0x03);
+        QCOMPARE(PubKey::fromHex(pubKey.toHex()), pubKey);
+
+        const std::string message = "aller-retour";
+        QVERIFY(crypto::verifySignature(message, crypto::signData(message, key), crypto::decodePubKey(pubKey)));
+        EVP_PKEY_free(key);
+
+        PubKey badPrefix = pubKey;
+        badPrefix[0] = 0x04;
+        QVERIFY(!crypto::decodePubKey(badPrefix));
+        QVERIFY(!crypto::decodePubKey(PubKey{}));
+        // x = 5 : x^3 + 7 n'est pas un carré modulo p, aucun point de la courbe n'a cette abscisse
+        QVERIFY(!crypto::decodePubKey(PubKey::fromHex("020000000000000000000000000000000000000000000000000000000000000005")));
+    }
+
+    // Racine de Merkle : nombre impair de feuilles, comparée à un calcul séquentiel
+    void merkleRootMatchesReference() {
+        EVP_PKEY* key = crypto::createPrivateKey();
+        const PubKey pubKey = crypto::getPubKey(key);
+        std::vector<Transaction> txs;
+        for (uint32_t i = 0; i < 6; ++i) {
+            txs.emplace_back(Inputs{OutputReference(i, 0, 0)}, Outputs{Output(COIN, pubKey)});
+            txs.back().sign(key);
+        }
+        EVP_PKEY_free(key);
+
+        const std::vector<Transaction> five(txs.begin(), txs.begin() + 5);
+        std::vector<Hash> level;
+        for (const auto& tx : five) level.push_back(tx.getTxid());
+        while (level.size() > 1) {
+            if (level.size() % 2 != 0) level.push_back(level.back());
+            std::vector<Hash> parents;
+            for (size_t i = 0; i < level.size(); i += 2) {
+                parents.push_back(crypto::hashData(std::string(reinterpret_cast<const char*>(level[i].data()), 2 * Hash::SIZE)));
+            }
+            level = parents;
+        }
+        QCOMPARE(loadBlockTransactions(five).getMerkleRoot(), level.front());
+
+        std::vector<Transaction> changed = five;
+        changed[4] = txs[5];
+        QVERIFY(loadBlockTransactions(changed).getMerkleRoot() != level.front());
+    }
+
+    // Protocole v3 : varints et tailles annoncées venant d'un pair, refusés avant toute allocation
+    void compactRejectsMalformed() {
+        auto rejects = [](std::vector<uint8_t> bytes, auto value) {
+            try {
+                cereal::CompactInputArchive ar(bytes);
+                ar(value);
+            } catch (const cereal::Exception&) {
+                return true;
+            }
+            return false;
+        };
+        QVERIFY(rejects(std::vector<uint8_t>(11, 0x80), uint64_t{}));       // varint trop long
+        QVERIFY(rejects({0xFF, 0xFF, 0x04}, uint16_t{}));                    // hors de uint16_t
+        QVERIFY(rejects({0xE8, 0x07, 0x00}, std::vector<uint8_t>{}));        // 1000 éléments annoncés, 1 octet de payload
+        QVERIFY(rejects({0x01, 0x01, 0x00, 0x00}, Inputs{}));                // delta négatif depuis le bloc 0
+        QVERIFY(!rejects({0xAC, 0x02}, uint16_t{}));                         // 300
+    }
+};
+
+QTEST_APPLESS_MAIN(TestProtocol)
+#include "test_protocol.moc"
@@ -0,0 +1,130 @@
+#include <QtTest/QtTest>
+
+#include <openssl/sha.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "cryptography/Sha256.hpp"
+
+namespace {
+    const sha256::Backend kBackends[] = {sha256::Backend::Portable, sha256::Backend::Avx2, sha256::Backend::ShaNi};
+
+    std::span<const uint8_t> bytes(const std::string& str) {
+        return {reinterpret_cast<const uint8_t*>(str.data()), str.size()};
+    }
+
+    std::string toHex(const uint8_t* data, size_t len) {
+        static const char digits[] = "0123456789abcdef";
+        std::string hex;
+        for (size_t i = 0; i < len; ++i) {
+            hex += digits[data[i] >> 4];
+            hex += digits[data[i] & 0x0F];
+        }
+        return hex;
+    }
+
+    std::string digestHex(const std::string& message) {
+        uint8_t out[sha256::DIGEST_SIZE];
+        sha256::hash(bytes(message), out);
+        return toHex(out, sizeof(out));
+    }
+
+    std::string opensslHex(const std::string& message) {
+        uint8_t out[SHA256_DIGEST_LENGTH];
+        SHA256(reinterpret_cast<const unsigned char*>(message.data()), message.size(), out);
+        return toHex(out, sizeof(out));
+    }
+}
+
+// Vérifie chaque back end SHA-256 supporté par la machine contre les vecteurs NIST et OpenSSL
+class TestSha256 : public QObject {
+    Q_OBJECT
+
+    sha256::Backend defaultBackend = sha256::Backend::Portable;
+
+private slots:
+    void initTestCase() {
+        defaultBackend = sha256::activeBackend();
+        for (auto backend : kBackends) {
+            qInfo() << "backend" << sha256::backendName(backend) << (sha256::isSupported(backend) ? "supported" : "not supported");
+        }
+        QVERIFY(sha256::isSupported(sha256::Backend::Portable));
+    }
+
+    void cleanupTestCase() {
+        QVERIFY(sha256::setBackend(defaultBackend));
+    }
+
+    // FIPS 180-2, annexe B + vecteurs courts NIST
+    void nistVectors() {
+        for (auto backend : kBackends) {
+            if (!sha256::setBackend(backend)) continue;
+            QCOMPARE(digestHex(""), std::string("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"));
+            QCOMPARE(digestHex("abc"), std::string("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"));
+            QCOMPARE(digestHex("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"),
+                     std::string("248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1"));
+            QCOMPARE(digestHex("abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu"),
+                     std::string("cf5b16a778af8380036ce59e7b0492370b249b11e8f07a51afac45037afee9d1"));
+            QCOMPARE(digestHex(std::string(1000000, 'a')),
+                     std::string("cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0"));
+        }
+    }
+
+    // Toutes les longueurs autour des frontières de blocs (padding sur 1 ou 2 blocs)
+    void matchesOpenSSL() {
+        std::mt19937 rng(42);
+        for (auto backend : kBackends) {
+            if (!sha256::setBackend(backend)) continue;
+            for (size_t len = 0; len <= 300; ++len) {
+                std::string message(len, '\0');
+                for (auto& c : message) c = static_cast<char>(rng());
+                QCOMPARE(digestHex(message), opensslHex(message));
+            }
+        }
+    }
+
+    // Découpage arbitraire des données passées à update()
+    void incrementalUpdates() {
+        std::string message(1000, '\0');
+        for (size_t i = 0; i < message.size(); ++i) message[i] = static_cast<char>(i * 31);
+        const std::string expected = opensslHex(message);
+
+        for (auto backend : kBackends) {
+            if (!sha256::setBackend(backend)) continue;
+            for (size_t chunk : {1, 3, 63, 64, 65, 200}) {
+                sha256::Hasher hasher;
+                for (size_t pos = 0; pos < message.size(); pos += chunk) {
+                    hasher.update(bytes(message.substr(pos, chunk)));
+                }
+                uint8_t out[sha256::DIGEST_SIZE];
+                hasher.finalize(out);
+                QCOMPARE(toHex(out, sizeof(out)), expected);
+            }
+        }
+    }
+
+    // Lots de messages : lanes AVX2 pour les paquets de même longueur, repli sinon
+    void hashManyMatchesSingle() {
+        std::vector<std::string> messages;
+        for (size_t len : {0, 55, 56, 64, 119, 200}) {
+            for (int i = 0; i < 9; ++i) messages.push_back(std::string(len, static_cast<char>('a' + i)));
+        }
+        messages.push_back("longueur différente");
+        std::vector<std::span<const uint8_t>> spans;
+        for (const auto& m : messages) spans.push_back(bytes(m));
+
+        for (auto backend : kBackends) {
+            if (!sha256::setBackend(backend)) continue;
+            std::vector<uint8_t> out(messages.size() * sha256::DIGEST_SIZE);
+            sha256::hashMany(spans, out.data());
+            for (size_t i = 0; i < messages.size(); ++i) {
+                QCOMPARE(toHex(out.data() + i * sha256::DIGEST_SIZE, sha256::DIGEST_SIZE), opensslHex(messages[i]));
+            }
+        }
+    }
+};
+
+QTEST_APPLESS_MAIN(TestSha256)
+#include "test_sha256.moc"